@@ -20,6 +20,7 @@
 #include "BlockingSound.h"
 #include "BlockingSoundConsts.h"
 #include "types-tjw.h"
+#include "profile.h"
 
 void PlaySound(unsigned short periodUs, unsigned short durationMs)
 {
@@ -33,7 +34,7 @@ void PlaySound(unsigned short periodUs, unsigned short durationMs)
 	byte periodm = periodUs / 1000;
 	byte period10u = (periodUs % 1000) / 10;
 	
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_BLOCKING_SOUND);
 	
 	// Loop playing single cycles until we've done the required duration.
 	// But, round to the nearest zero-going half-cycle, so we can leave the pin low.
@@ -64,7 +65,7 @@ void PlaySound(unsigned short periodUs, unsigned short durationMs)
 		clear_wdt();
 	}		
 	
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_BLOCKING_SOUND);
 }
 
 void PlayClick(void)
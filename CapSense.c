@@ -6,11 +6,12 @@
 #define IN_CAPSENSE
 
 #include <system.h>
-#include <memory.h>
 #include <stdlib.h>
 
 #include "eeprom-tjw.h"
 #include "math-tjw.h"
+#include "mem-tjw.h"
+#include "power.h"
 
 #include "CapSense.h"
 #include "CapSense-consts.h"
@@ -96,34 +97,34 @@ void InitCapSense(void)
 	vrcon = 0x8D;  // Enable the voltage reference, in the low range, as 21/32 of Vdd.
 	
 	#if CAPSENSE_CHANNELS & CAPSENSE_CHANNEL0
-	ansel.0 = 1;  // on RA0, AN0
-	trisa.0 = 1;
+	set_bit(ansel, 0);  // on RA0, AN0
+	set_bit(trisa, 0);
 	#endif
 	#if CAPSENSE_CHANNELS & CAPSENSE_CHANNEL1
-	ansel.1 = 1;  // on RA1, AN1
-	trisa.1 = 1;
+	set_bit(ansel, 1);  // on RA1, AN1
+	set_bit(trisa, 1);
 	#endif
 	#if CAPSENSE_CHANNELS & CAPSENSE_CHANNEL2
-	anselh.1 = 1;  // on RB3, AN9
-	trisb.3 = 1;
+	set_bit(anselh, 1);  // on RB3, AN9
+	set_bit(trisb, 3);
 	#endif
 	#if CAPSENSE_CHANNELS & CAPSENSE_CHANNEL3
-	anselh.2 = 1;  // on RB1, AN10
-	trisb.1 = 1;
+	set_bit(anselh, 2);  // on RB1, AN10
+	set_bit(trisb, 1);
 	#endif
 
 	// Set current to the first one we're using.
 	currentCapSenseChannel = FIRST_CAPSENSE_CHANNEL;
 
 	// The low voltage reference is always used, and is on RA2, AN2.
-	ansel.2 = 1;
-	trisa.2 = 1;
+	set_bit(ansel, 2);
+	set_bit(trisa, 2);
 	
 	// The SR latch outputs on RA5, which is also C2OUT.
-	trisa.5 = 0;
+	clear_bit(trisa, 5);
 	
 	// RC0 is T1CKI, which must be hard-wired to C2OUT externally.
-	trisc.0 = 1;
+	set_bit(trisc, 0);
 	
 	// Timer 1 takes its input from the T1CKI pin.
 	t1con.TMR1CS = 1;
@@ -131,16 +132,17 @@ void InitCapSense(void)
 	// Set up the interrupt on TMR0 overflow.
 	// It runs free, and we check TMR1's value on each TMR0 overflow interrupt.
 	InitUiTime_Timer0();
+	PowerNeedClock(POWER_CAPSENSE);
 	
 	// Clear all bins.
 	csCurrentBin = 0;
-	memset(csBin, 0, sizeof(csBin)); 
-	memset(csBaseline, 0, sizeof(csBaseline));  // Set to zero to prevent any presses until we've had time to stabilize.
-	memset(csReadings, 0, sizeof(csReadings));
+	fillBytes((char*) csBin, 0, sizeof(csBin)); 
+	fillBytes((char*) csBaseline, 0, sizeof(csBaseline));  // Set to zero to prevent any presses until we've had time to stabilize.
+	fillBytes((char*) csReadings, 0, sizeof(csReadings));
 	csLastBinTicks = ticks;
 	csLastDownPolls = 255;
 	csHoldingButton = NO_CAPSENSE_BUTTONS;
-	memset(csDownInBin, 0, sizeof(csDownInBin));
+	fillBytes((char*) csDownInBin, 0, sizeof(csDownInBin));
 	
 	read_eeprom_block(CAPSENSE_EEPROM_ADDR, (char*) csThresholds, CAPSENSE_EEPROM_LEN);
 
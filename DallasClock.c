@@ -1,12 +1,14 @@
 // Dallas real-time clock implementation.
 
 #include <system.h>
+#include <memory.h>
 
 #define IN_DALLAS_CLOCK
 #include "DallasClock.h"
 
 #include "DallasClock_consts.h"
 #include "i2c_driver.h"
+#include "crc_8bit.h"
 
 #define DIRECTION_WRITE  0
 #define DIRECTION_READ  1
@@ -19,18 +21,38 @@
 
 #define I2C_SLAVE_ADDRESS  0xD0  // For the DS1307 RTC module.
 
+// Register addresses.
+#define CLOCK_CONTROL_REG  0x07
+
+#define CLOCK_NVRAM_START  0x08
+
+// Control register value: SQWE on, RS1:0 = 00 for 1 Hz.
+#define CLOCK_CONTROL_SQW_1HZ  0x10
+
+// Hours register bits.
+#define CLOCK_12_HOUR_BIT  6
+#define CLOCK_PM_BIT  5
+
+
+// Releases the bus after an error, and returns false.
+// A slave that NACKs still needs a stop before anyone can use the bus again.
+static byte FailI2C(void)
+{
+	i2c_stop();
+	return false;
+}
 
 // Writes the specified bytes starting at the specified register; returns nonzero on success.
 byte WriteToI2C(byte address, byte* values, byte len)
 {
 	i2c_start();
 	if (i2c_write(I2C_SLAVE_ADDRESS | DIRECTION_WRITE))
-		return false;
+		return FailI2C();
 	if (i2c_write(address))
-		return false;
+		return FailI2C();
 	while (len--)
 		if (i2c_write(*values++))
-			return false;
+			return FailI2C();
 		
 	i2c_stop();
 	return true;
@@ -41,11 +63,11 @@ byte WriteByteToI2C(byte address, byte value)
 {
 	i2c_start();
 	if (i2c_write(I2C_SLAVE_ADDRESS | DIRECTION_WRITE))
-		return false;
+		return FailI2C();
 	if (i2c_write(address))
-		return false;
+		return FailI2C();
 	if (i2c_write(value))
-		return false;
+		return FailI2C();
 		
 	i2c_stop();
 	return true;
@@ -58,14 +80,14 @@ byte ReadFromI2C(byte address, byte* retValues, byte len)
 	// Set the register pointer that we want to read from.
 	i2c_start();
 	if (i2c_write(I2C_SLAVE_ADDRESS | DIRECTION_WRITE))
-		return false;
+		return FailI2C();
 	if (i2c_write(address))
-		return false;
+		return FailI2C();
 	
 	// Now do the read.
 	i2c_restart();
 	if (i2c_write(I2C_SLAVE_ADDRESS | DIRECTION_READ))
-		return false;
+		return FailI2C();
 	while (len--)
 		*retValues++ = i2c_read(len == 0? NO_ACKNOWLEDGE: ACKNOWLEDGE);
 	i2c_stop();
@@ -126,4 +148,200 @@ void WriteClock(void)
 	WriteToI2C(0, &stopByte, 1);
 
 	WriteToI2C(0, currentTimeBuf, 7);
-}
\ No newline at end of file
+	
+	clockResyncNeeded = 1;
+}
+
+void SetClockRegister(byte index, byte newValue)
+{
+	WriteByteToI2C(index, newValue);
+}
+
+
+//====================================================================
+// Cached time
+
+// Converts a BCD byte to binary.
+inline byte FromBCD(byte bcd)
+{
+	byte tens = bcd >> 4;
+	return (tens << 3) + (tens << 1) + (bcd & 0x0F);
+}
+
+byte InitDallasClockSqw(void)
+{
+	byte result = InitDallasClock();
+	SetClockRegister(CLOCK_CONTROL_REG, CLOCK_CONTROL_SQW_1HZ);
+	ResyncClock();
+	return result;
+}
+
+byte ResyncClock(void)
+{
+	while (1) {
+		// If a seconds edge comes in while the chip is being read, the reading may be stale;
+		// the cached seconds tell if one did.
+		byte secondsBefore = clockTime.seconds;
+		
+		if (!ReadFromI2C(0, currentTimeBuf, 7))
+			return false;
+		
+		// Decode outside the critical section.
+		ClockTime t;
+		t.seconds = FromBCD(currentTime.seconds & 0x7F);  // without the CH bit
+		t.minutes = FromBCD(currentTime.minutes);
+		if (currentTime.hours.CLOCK_12_HOUR_BIT) {
+			t.hours = FromBCD(currentTime.hours & 0x1F);
+			if (t.hours == 12)
+				t.hours = 0;
+			if (currentTime.hours.CLOCK_PM_BIT)
+				t.hours += 12;
+		} else
+			t.hours = FromBCD(currentTime.hours & 0x3F);
+		t.dayOfWeek = currentTime.dayOfWeek;
+		t.dayOfMonth = FromBCD(currentTime.dayOfMonth);
+		t.month = FromBCD(currentTime.month);
+		t.year = FromBCD(currentTime.year);
+		
+		intcon.GIE = 0;
+		if (clockTime.seconds == secondsBefore) {
+			// No edge since the read, so it's current, and any resync request it would
+			// have cleared was made before it.
+			memcpy(&clockTime, &t, sizeof(clockTime));
+			clockResyncNeeded = 0;
+			intcon.GIE = 1;
+			return true;
+		}
+		intcon.GIE = 1;
+		
+		// Otherwise read it again; the next edge is a second away.
+	}
+}
+
+void ClockSecondInterrupt(void)
+{
+	if (++clockTime.seconds < 60)
+		return;
+	clockTime.seconds = 0;
+	
+	if (++clockTime.minutes < 60)
+		return;
+	clockTime.minutes = 0;
+	
+	// Reread the chip every hour, to correct any missed edges,
+	// and so the chip's calendar handles the date.
+	clockResyncNeeded = 1;
+	
+	if (++clockTime.hours < 24)
+		return;
+	clockTime.hours = 0;
+	
+	// Good enough until the main loop resyncs, moments from now.
+	if (++clockTime.dayOfWeek > 7)
+		clockTime.dayOfWeek = 1;
+	++clockTime.dayOfMonth;
+}
+
+void GetClockTime(ClockTime* t)
+{
+	intcon.GIE = 0;
+	memcpy(t, &clockTime, sizeof(clockTime));
+	intcon.GIE = 1;
+}
+
+
+//====================================================================
+// Battery-backed RAM
+
+// Returns true if the given range is within the NVRAM.
+// (The chip's register pointer would otherwise wrap around into the clock registers.)
+inline byte NvramRangeOK(byte offset, byte len)
+{
+	return offset < CLOCK_NVRAM_SIZE && len <= CLOCK_NVRAM_SIZE - offset;
+}
+
+byte ReadClockNvram(byte offset, byte* buffer, byte len)
+{
+	if (!NvramRangeOK(offset, len))
+		return false;
+	return ReadFromI2C(CLOCK_NVRAM_START + offset, buffer, len);
+}
+
+byte WriteClockNvram(byte offset, byte* buffer, byte len)
+{
+	if (!NvramRangeOK(offset, len))
+		return false;
+	return WriteToI2C(CLOCK_NVRAM_START + offset, buffer, len);
+}
+
+byte ReadClockNvramByte(byte offset)
+{
+	byte result;
+	if (ReadClockNvram(offset, &result, 1))
+		return result;
+	else
+		return 0xFF;
+}
+
+byte WriteClockNvramByte(byte offset, byte value)
+{
+	return WriteClockNvram(offset, &value, 1);
+}
+
+// Returns the check byte for a record.
+// It's inverted, so a record of all zeros - e.g. cleared RAM - doesn't check out.
+static byte RecordCRC(byte* buffer, byte len)
+{
+	crc8Init();
+	while (len--)
+		crc8(*buffer++);
+	return ~crc;
+}
+
+byte ReadClockRecord(byte offset, byte* buffer, byte len)
+{
+	if (len >= CLOCK_NVRAM_SIZE || !NvramRangeOK(offset, len + 1))
+		return false;
+	
+	// Read the data and the check byte in one burst.
+	i2c_start();
+	if (i2c_write(I2C_SLAVE_ADDRESS | DIRECTION_WRITE))
+		return FailI2C();
+	if (i2c_write(CLOCK_NVRAM_START + offset))
+		return FailI2C();
+	
+	i2c_restart();
+	if (i2c_write(I2C_SLAVE_ADDRESS | DIRECTION_READ))
+		return FailI2C();
+	byte* p = buffer;
+	byte i = len;
+	while (i--)
+		*p++ = i2c_read(ACKNOWLEDGE);
+	byte check = i2c_read(NO_ACKNOWLEDGE);
+	i2c_stop();
+	
+	return check == RecordCRC(buffer, len);
+}
+
+byte WriteClockRecord(byte offset, byte* buffer, byte len)
+{
+	if (len >= CLOCK_NVRAM_SIZE || !NvramRangeOK(offset, len + 1))
+		return false;
+	
+	byte check = RecordCRC(buffer, len);
+	
+	// Write the data and the check byte in one burst.
+	i2c_start();
+	if (i2c_write(I2C_SLAVE_ADDRESS | DIRECTION_WRITE))
+		return FailI2C();
+	if (i2c_write(CLOCK_NVRAM_START + offset))
+		return FailI2C();
+	while (len--)
+		if (i2c_write(*buffer++))
+			return FailI2C();
+	if (i2c_write(check))
+		return FailI2C();
+	
+	i2c_stop();
+	return true;
+}
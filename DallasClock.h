@@ -40,10 +40,83 @@ DALLAS_CLOCK_EXTERN struct {
 #define currentTimeBuf  ((byte*) &currentTime)
 
 // Reads and writes the entire currentTime structure all at once.
+// Writing also asks for the cached time (below) to be refreshed.
 byte ReadClock(void);
 void WriteClock(void);
 
 // Writes an individual clock register.
 void SetClockRegister(byte index, byte newValue);
 
+
+//====================================================================
+// Cached time, advanced by the 1 Hz square wave
+//
+// Wire the DS1307's SQW/OUT pin (open-drain; it needs a pull-up) to an interrupt pin,
+// and call ClockSecondInterrupt() from the ISR on each falling edge.
+// The time is then kept in RAM, in binary, and reading it costs no I2C traffic.
+// The chip is only read again when the hour changes (which also takes care of
+// the date rolling over), or when you call ResyncClock().
+
+// The cached time, in binary.  Use GetClockTime() to read it consistently.
+typedef struct {
+	byte seconds;  // 0-59
+	byte minutes;  // 0-59
+	byte hours;  // 0-23
+	byte dayOfWeek;  // 1-7
+	byte dayOfMonth;  // 1-31
+	byte month;  // 1-12
+	byte year;  // 0-99
+} ClockTime;
+
+DALLAS_CLOCK_EXTERN ClockTime clockTime;
+
+// Set by the ISR when the cache should be refreshed from the chip.
+DALLAS_CLOCK_EXTERN bit clockResyncNeeded;
+
+// Call this instead of InitDallasClock() to use the cached time.
+// Turns on the 1 Hz square wave and fills the cache.
+// Returns false if the clock appears to be set to the epoch.
+byte InitDallasClockSqw(void);
+
+// Call this from the ISR on each falling edge of SQW.
+void ClockSecondInterrupt(void);
+
+// Rereads the chip into the cache now.  Returns false on error.
+byte ResyncClock(void);
+
+// Call this from the main loop; it rereads the chip when the ISR asks for it.
+inline void UpdateDallasClock(void)
+{
+	if (clockResyncNeeded)
+		ResyncClock();
+}
+
+// Copies the cached time into t, safely from outside the ISR.
+void GetClockTime(ClockTime* t);
+
+
+//====================================================================
+// Battery-backed RAM
+//
+// The DS1307 has 56 bytes of RAM, kept alive by its battery, that can be written
+// any number of times.  Use it instead of EEPROM for state that changes often.
+// Offsets here run from 0 to CLOCK_NVRAM_SIZE - 1; multi-byte transfers are done
+// as a single I2C burst.
+// Each function returns false on an I2C error, or if the range doesn't fit.
+
+#define CLOCK_NVRAM_SIZE  56
+
+byte ReadClockNvram(byte offset, byte* buffer, byte len);
+byte WriteClockNvram(byte offset, byte* buffer, byte len);
+
+// Returns 0xFF on error - so check the return from ReadClockNvram() if that matters.
+byte ReadClockNvramByte(byte offset);
+byte WriteClockNvramByte(byte offset, byte value);
+
+// Records are stored as the given bytes plus a CRC, so each one takes len + 1 bytes.
+// Reading returns false if the CRC doesn't match - e.g. the battery died,
+// power failed partway through a write, or the record was never written.
+byte ReadClockRecord(byte offset, byte* buffer, byte len);
+byte WriteClockRecord(byte offset, byte* buffer, byte len);
+
 #endif
\ No newline at end of file
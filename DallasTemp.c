@@ -19,6 +19,7 @@
 
 #include "crc_8bit.h"
 #include "onewire.h"
+#include "power.h"
 #include "types-tjw.h"
 
 #include "DallasTemp.h"
@@ -300,3 +301,20 @@ fixed16 DT_GetLastTemp(byte bus)
 	return result;
 }
 
+byte DT_ReadTempFineTask(Task* t, byte bus, fixed16* result)
+{
+	TASK_BEGIN(t);
+	
+	if (!DT_StartReadFine(bus)) {
+		*result = DT_BAD_TEMPERATURE;
+		TASK_EXIT(t);
+	}
+	
+	PowerNeedClock(POWER_TEMP);
+	TASK_SLEEP_MS(t, ConversionTime_HighRes);
+	PowerReleaseClock(POWER_TEMP);
+	
+	*result = DT_GetLastTemp(bus);
+	
+	TASK_END(t);
+}
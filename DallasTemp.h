@@ -38,6 +38,7 @@
 
 #include "types-tjw.h"
 #include "fixed16.h"
+#include "task.h"
 
 
 #define DT_MIN_TEMP  -55
@@ -84,3 +85,11 @@ unsigned char DT_ReadDone(byte bus);
 
 // Returns the result of the last temperature conversion on the given bus.
 fixed16 DT_GetLastTemp(byte bus);
+
+// Task reading (see task.h):
+
+// Same as DT_ReadTempFine, but waits for the conversion without blocking.
+// Returns TASK_RUNNING until it's done, then TASK_DONE with the temperature in *result,
+// or DT_BAD_TEMPERATURE if there's no sensor on the bus.
+// No other 1-Wire commands should be done on the bus until it's done.
+byte DT_ReadTempFineTask(Task* t, byte bus, fixed16* result);
@@ -61,6 +61,18 @@ void ConfirmMessage(void)
 	while (c != ENTER_KEY);
 }
 
+byte ConfirmMessageTask(Task* t)
+{
+	TASK_BEGIN(t);
+	
+	ShowStatusChar(OK_CHAR);
+	lcd_gotoxy(DISPLAY_WIDTH - 1, 0);
+	
+	TASK_WAIT_UNTIL(t, kb_trygetc() == ENTER_KEY);
+	
+	TASK_END(t);
+}
+
 void PrintCentered(const char* msg, byte field)
 {
 	byte leftPad = (field - strlen(msg)) / 2;
@@ -23,6 +23,7 @@
 #ifndef _LCDUI_H
 #define _LCDUI_H
 
+#include "task.h"
 #include "types-tjw.h"
 
 
@@ -51,6 +52,10 @@ void HighlightStatusChar(void);
 // and waits for the user to press Enter.
 void ConfirmMessage(void);
 
+// Same, but as a task (see task.h): lets other tasks run while waiting.
+// Requires kb_trygetc() in LCDUIConsts.h.
+byte ConfirmMessageTask(Task* t);
+
 // Prints the given message centered in a field of the given width,
 // starting at the current cursor position.
 // Erases the rest of the field.
@@ -10,6 +10,13 @@ inline char kb_getc(void)
 	return WaitForInput(NO_BTN);
 }
 
+// Only needed for ConfirmMessageTask().
+// Returns the value of a button that has been pressed, if any, without waiting.
+inline char kb_trygetc(void)
+{
+	return GetButton();
+}
+
 #define LEFT_KEY  PREV_BTN
 #define ENTER_KEY  SELECT_BTN
 #define RIGHT_KEY  NEXT_BTN
@@ -23,6 +23,7 @@
 #include "SoundConsts.h"
 
 #include "shadowRegs.h"
+#include "power.h"
 #include "types-tjw.h"
 
 byte soundTimeoutHigh;
@@ -73,6 +74,10 @@ void StartSound(unsigned short periodUs)
 
 void PlaySound(unsigned short periodUs, unsigned short durationMs)
 {
+	// Notes, and timed silences, need the ms tick to run out.
+	if (periodUs || durationMs)
+		PowerNeedClock(POWER_SOUND);
+
 	StartSound(periodUs);
 	remainingDuration = durationMs;
 	followingSilence = 0;
@@ -295,6 +300,8 @@ void PlaySong(const char* song)
 	
 	strncpy(currentSong, song, MAX_SONG_LENGTH);
 	currentSongIndex = 0;
+	
+	PowerNeedClock(POWER_SOUND);
 }
 
 void TurnOffAllSound(void)
@@ -341,6 +348,9 @@ void UpdateSong(void)
 			PlayNextNote();
 		}
 	}
+
+	if (!remainingDuration && !IsSoundPlaying())
+		PowerReleaseClock(POWER_SOUND);
 }
 
 void SoundInterrupt(void)
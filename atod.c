@@ -94,3 +94,18 @@ void AcquireAndConvertAD(void)
 	// Turn off A/D.
 	adcon0.ADON = 0;
 }
+
+byte AcquireAndConvertADTask(Task* t)
+{
+	TASK_BEGIN(t);
+	
+	adcon0.ADON = 1;
+	delay_us(40);
+	adcon0.GO_DONE = 1;
+	
+	TASK_WAIT_UNTIL(t, !adcon0.GO_DONE);
+	
+	adcon0.ADON = 0;
+	
+	TASK_END(t);
+}
@@ -23,6 +23,7 @@
 #define __ATOD_H
 
 #include "fixed16.h"
+#include "task.h"
 #include "types-tjw.h"
 
 
@@ -77,6 +78,10 @@ void TurnOffADChannel(byte channel);
 // The result will be in adresh/adresl.
 void AcquireAndConvertAD(void);
 
+// Task version of AcquireAndConvertAD() (see task.h).
+// Still blocks for the short settling time, but lets other tasks run during the conversion.
+byte AcquireAndConvertADTask(Task* t);
+
 // Reads the given A/D channel.
 inline void ReadADChannel(byte channel)
 {
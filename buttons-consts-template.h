@@ -28,6 +28,13 @@
 #define FIRST_BTN  PREV_BTN
 #define LAST_BTN  NEXT_BTN
 
+// Define this to let the power manager (power.h) sleep while no button is down.
+// InitButtons() then enables interrupt-on-change on the button pins, so a press wakes the CPU,
+// and ButtonsInterrupt() has to be called from the interrupt handler.
+// The buttons have to be on PORTB, and on most chips, on RB4-RB7.
+// Without it, the buttons keep the clock running, since nothing would notice a press in SLEEP.
+//#define BUTTONS_WAKE_ON_CHANGE
+
 // Minimum down events before recognizing a button press, in button check periods (often, ms).
 #define MIN_DOWNS  40  // max 254
 
@@ -22,6 +22,7 @@
 #include "buttons.h"
 
 #include "math-tjw.h"
+#include "power.h"
 
 
 #if NUM_BTNS > 1
@@ -35,6 +36,14 @@ void CheckButtons(void)
 {
 	// We only care about button presses, not releases.
 	// So, just keep track of how many consecutive "down" events we've seen for each button.
+	
+	#ifdef BUTTONS_WAKE_ON_CHANGE
+	// Keep the clock running while debouncing; a pin change wakes us for the next press.
+	if (IS_ANY_BTN_DOWN)
+		PowerNeedClock(POWER_BUTTONS);
+	else
+		PowerReleaseClock(POWER_BUTTONS);
+	#endif
 
 	#if NUM_BTNS > 1
 	byte* down = &downs[0];
@@ -79,6 +88,19 @@ void InitButtons(void)
 	#else
 	downs = 0;
 	#endif
+	
+	#ifdef BUTTONS_WAKE_ON_CHANGE
+	// On these, each PORTB pin has its own enable; elsewhere, RB4-RB7 always have it.
+	#if defined(_PIC16F883) || defined(_PIC16F886) || defined(_PIC16F690)
+	iocb |= ALL_BTNS_MASK;
+	#endif
+	BUTTON_PORT;
+	intcon.RBIF = 0;
+	intcon.RBIE = 1;
+	#else
+	// Nothing would notice a press while the CPU slept, so don't let it.
+	PowerNeedClock(POWER_BUTTONS);
+	#endif
 }
 
 byte GetButton(void)
@@ -32,6 +32,7 @@
 
 
 #include "types-tjw.h"
+#include "power.h"
 
 #define NO_BTN  0
 
@@ -83,6 +84,20 @@ void InitButtons(void);
 // Sets a bit in buttonsPressed whenever a button is pressed and stable long enough.
 void CheckButtons(void);
 
+#ifdef BUTTONS_WAKE_ON_CHANGE
+// Call this from the interrupt handler.
+// Acknowledges the pin change that woke the CPU, and keeps it awake
+// until CheckButtons() sees the buttons released.
+inline void ButtonsInterrupt(void)
+{
+	if (intcon.RBIF) {
+		BUTTON_PORT;  // reading the port ends the mismatch
+		intcon.RBIF = 0;
+		PowerNeedClock(POWER_BUTTONS);
+	}
+}
+#endif
+
 // Returns the *_BTN index (from buttons-consts.h) corresponding to the next key pressed, 
 // or NO_BTN if none was pressed.
 // Basically pulls out the bits of buttonsPressed and zeroes them out.
@@ -21,6 +21,8 @@
 
 #include <system.h>
 
+#include "types-tjw.h"
+
 #define IN_CRC_8BIT
 
 #include "crc_8bit.h"
@@ -35,7 +37,7 @@
 #ifdef CRC8_IMP_TABLE
 
 // crc array from the Maxim ApNote
-rom char* crc_array = {
+ROM_TABLE(char, crc_array) = {
 	0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83, 
 	0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41, 
 	0x9d, 0xc3, 0x21, 0x7f, 0xfc, 0xa2, 0x40, 0x1e, 
@@ -83,12 +85,12 @@ unsigned char crc8(unsigned char data)
 #ifdef CRC8_IMP_NIBBLES
 
 // CRC arrays for the nibble-wise routine.
-rom char* r1 = {
+ROM_TABLE(char, r1) = {
 	0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83, 
 	0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41, 
 };
 
-rom char* r2 = {
+ROM_TABLE(char, r2) = {
 	0x00, 0x9d, 0x23, 0xbe, 0x46, 0xdb, 0x65, 0xf8,
 	0x8c, 0x11, 0xaf, 0x32, 0xca, 0x57, 0xe9, 0x74
 };
@@ -33,10 +33,10 @@ byte UpdateDayTime(void)
 {
 	byte result = false;
 	
+	// seconds is only advanced by UpdateUiSeconds(), from the main loop,
+	// so there's no need to mask interrupts here.
 	while (seconds >= SECONDS_PER_MINUTE) {
-		intcon.GIE = 0;
 		seconds -= SECONDS_PER_MINUTE;
-		intcon.GIE = 1;
 		
 		// Add a minute.
 		++currentTime;
@@ -45,6 +45,9 @@ byte UpdateDayTime(void)
 			// We'll assume less than a minute has passed since we noticed.
 			currentTime = 0;
 			result = true;
+			
+			if (currentDate.month)
+				AdvanceDate(&currentDate);
 		}
 	}
 	
@@ -56,3 +59,197 @@ void DecodeDayTime(dayTime_t time, byte& hours, byte& minutes)
 	hours = time / MINUTES_PER_HOUR;
 	minutes = time % MINUTES_PER_HOUR;
 }
+
+
+//====================================================================
+// Calendar
+
+#define SECONDS_PER_HOUR  3600
+#define SECONDS_PER_DAY  86400
+
+// Days in a 4-year cycle, starting with the leap year.
+#define DAYS_PER_4_YEARS  (366 + 3 * 365)
+
+// Jan. 1, 2000 was a Saturday.
+#define EPOCH_WEEKDAY  SATURDAY
+
+ROM_TABLE(char, monthDays) = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+// Divides *x by unit, leaving the remainder in *x, and returns the quotient.
+// The quotient must fit in quotientBits bits, and unit << (quotientBits - 1) must fit in a long.
+// This is ordinary shift-and-subtract long division, but it's much cheaper than the
+// library's general-purpose division when the quotient is short.
+static unsigned short TakeUnits(unsigned long* x, unsigned long unit, byte quotientBits)
+{
+	unsigned short result = 0;
+	unsigned long chunk = unit << (quotientBits - 1);
+	
+	while (quotientBits--) {
+		result <<= 1;
+		if (*x >= chunk) {
+			*x -= chunk;
+			result |= 1;
+		}
+		chunk >>= 1;
+	}
+	
+	return result;
+}
+
+byte DaysInMonth(byte month, byte year)
+{
+	if (month == 2 && IsLeapYear(year))
+		return 29;
+	else if (month == 0 || month > 12)
+		return 0;
+	else
+		return monthDays[month - 1];
+}
+
+byte WeekdayFromDayNumber(dayNumber_t days)
+{
+	unsigned long x = (unsigned long) days + EPOCH_WEEKDAY;
+	TakeUnits(&x, 7, 14);
+	return (byte) x;
+}
+
+void SetDate(byte year, byte month, byte day)
+{
+	currentDate.year = year;
+	currentDate.month = month;
+	currentDate.day = day;
+	currentDate.weekday = WeekdayFromDayNumber(DayNumberFromDate(&currentDate));
+}
+
+void AdvanceDate(date_t* date)
+{
+	if (++date->weekday > SATURDAY)
+		date->weekday = SUNDAY;
+	
+	if (++date->day > DaysInMonth(date->month, date->year)) {
+		date->day = 1;
+		if (++date->month > 12) {
+			date->month = 1;
+			++date->year;
+		}
+	}
+}
+
+dayNumber_t DayNumberFromDate(date_t* date)
+{
+	byte year = date->year;
+	
+	// Whole years, plus a day for each leap year before this one.
+	dayNumber_t result = (dayNumber_t) year * 365 + ((year + 3) >> 2);
+	
+	byte month;
+	for (month = 1; month < date->month; ++month)
+		result += DaysInMonth(month, year);
+	
+	return result + date->day - 1;
+}
+
+void DateFromDayNumber(dayNumber_t days, date_t* date)
+{
+	date->weekday = WeekdayFromDayNumber(days);
+	
+	// Whole 4-year cycles.
+	unsigned long x = days;
+	byte year = TakeUnits(&x, DAYS_PER_4_YEARS, 5) << 2;
+	unsigned short remaining = (unsigned short) x;
+	
+	// Whole years within the cycle, which starts with a leap year.
+	if (remaining >= 366) {
+		remaining -= 366;
+		++year;
+		while (remaining >= 365) {
+			remaining -= 365;
+			++year;
+		}
+	}
+	
+	// Whole months within the year.
+	byte month = 1;
+	byte length;
+	while (remaining >= (length = DaysInMonth(month, year))) {
+		remaining -= length;
+		++month;
+	}
+	
+	date->year = year;
+	date->month = month;
+	date->day = (byte) remaining + 1;
+}
+
+epoch_t MakeEpoch(date_t* date, byte hours, byte minutes, byte seconds)
+{
+	epoch_t result = (epoch_t) DayNumberFromDate(date) * SECONDS_PER_DAY;
+	result += (unsigned long) hours * SECONDS_PER_HOUR;
+	result += (unsigned short) minutes * SECONDS_PER_MINUTE + seconds;
+	return result;
+}
+
+void DecodeEpoch(epoch_t t, date_t* date, byte& hours, byte& minutes, byte& seconds)
+{
+	unsigned long x = t;
+	dayNumber_t days = TakeUnits(&x, SECONDS_PER_DAY, 16);
+	hours = TakeUnits(&x, SECONDS_PER_HOUR, 5);
+	minutes = TakeUnits(&x, SECONDS_PER_MINUTE, 6);
+	seconds = (byte) x;
+	
+	DateFromDayNumber(days, date);
+}
+
+epoch_t GetCurrentEpoch(void)
+{
+	if (currentDate.month == 0)
+		return INVALID_EPOCH;
+
+	byte hours, minutes;
+	GetDayTime(hours, minutes);
+	return MakeEpoch(&currentDate, hours, minutes, seconds);
+}
+
+// Returns the day of the month of the first Sunday on or after the given day.
+static byte SundayOnOrAfter(byte year, byte month, byte day)
+{
+	date_t date;
+	date.year = year;
+	date.month = month;
+	date.day = day;
+	byte weekday = WeekdayFromDayNumber(DayNumberFromDate(&date));
+	
+	if (weekday == SUNDAY)
+		return day;
+	else
+		return day + 7 - weekday;
+}
+
+// Returns true if DST is in effect, given the days of the month it starts (in startMonth)
+// and ends (in endMonth), and the local standard time hour it ends.
+// It always starts at 2:00 local standard time.
+static byte IsDSTBetween(date_t* date, byte hours, byte startMonth, byte startDay, byte endMonth, byte endDay, byte endHour)
+{
+	byte month = date->month;
+	
+	if (month == startMonth)
+		return date->day > startDay || (date->day == startDay && hours >= 2);
+	else if (month == endMonth)
+		return date->day < endDay || (date->day == endDay && hours < endHour);
+	else
+		return month > startMonth && month < endMonth;
+}
+
+byte IsDST_US(date_t* date, byte hours)
+{
+	return IsDSTBetween(date, hours, 
+		3, SundayOnOrAfter(date->year, 3, 8), 
+		11, SundayOnOrAfter(date->year, 11, 1), 1);  // 2:00 DST is 1:00 standard
+}
+
+byte IsDST_EU(date_t* date, byte hours)
+{
+	return IsDSTBetween(date, hours, 
+		3, SundayOnOrAfter(date->year, 3, 25), 
+		10, SundayOnOrAfter(date->year, 10, 25), 2);
+}
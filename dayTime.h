@@ -23,6 +23,12 @@
 	
 	Gets time from uiSeconds and uiTime.  Takes over uiSeconds's
 	global 'seconds' for use as the current seconds, 0-59.
+	
+	Also keeps the calendar date, for the years 2000-2099, once it's been set with SetDate().
+	Dates and times can be converted to and from "epoch" seconds since midnight, Jan. 1, 2000,
+	which makes timestamps and schedule comparisons simple integer compares.
+	The PIC has no divide instruction, so the conversions use only shifts, adds,
+	and compares against constants.
 */
 
 #ifndef __DAYTIME_H
@@ -47,15 +53,39 @@
 
 typedef unsigned short  dayTime_t;
 
+// A calendar date.
+typedef struct {
+	byte year;  // 0-99, for 2000-2099
+	byte month;  // 1-12
+	byte day;  // 1-31
+	byte weekday;  // 0-6, Sunday = 0
+} date_t;
+
+#define SUNDAY  0
+#define SATURDAY  6
+
+// Seconds since midnight, Jan. 1, 2000.
+typedef unsigned long  epoch_t;
+
+// Days since Jan. 1, 2000.
+typedef unsigned short  dayNumber_t;
+
 
 // This value is guaranteed never to be used for a valid dayTime.
 #define INVALID_DAYTIME  0x05DC  // AKA 25 hours, 0 minutes.
 
+// Likewise for an epoch_t; it's in 2136, well past the years a date_t holds.
+#define INVALID_EPOCH  0xFFFFFFFF
+
 
 // Don't change this outside of this module.
 // Format is minutes since midnight.
 DAYTIME_EXTERN dayTime_t currentTime;
 
+// Don't change this outside of this module either.
+// All zeroes until SetDate() is called; then advanced by UpdateDayTime().
+DAYTIME_EXTERN date_t currentDate;
+
 
 inline dayTime_t MakeDayTime(byte hours, byte minutes)
 {
@@ -76,4 +106,51 @@ byte UpdateDayTime(void);
 #define GetDayTime(hours, minutes)  DecodeDayTime(currentTime, hours, minutes)
 
 
+//====================================================================
+// Calendar
+
+// Returns true if the given year (0-99) is a leap year.
+// In 2000-2099, that's every fourth year, starting with 2000.
+inline byte IsLeapYear(byte year)
+{
+	return (year & 3) == 0;
+}
+
+// Returns the number of days in the given month (1-12) of the given year,
+// or 0 if the month is out of range, e.g. a currentDate that hasn't been set.
+byte DaysInMonth(byte month, byte year);
+
+// Sets the current date.  The weekday is filled in automatically.
+void SetDate(byte year, byte month, byte day);
+
+// Moves the given date forward by one day.
+void AdvanceDate(date_t* date);
+
+// Converts the given date to a day number, and back.
+// The weekday in date is ignored by DayNumberFromDate, and set by DateFromDayNumber.
+dayNumber_t DayNumberFromDate(date_t* date);
+void DateFromDayNumber(dayNumber_t days, date_t* date);
+
+// Returns the weekday (Sunday = 0) of the given day number.
+byte WeekdayFromDayNumber(dayNumber_t days);
+
+// Converts the given date and time of day to epoch seconds, and back.
+epoch_t MakeEpoch(date_t* date, byte hours, byte minutes, byte seconds);
+void DecodeEpoch(epoch_t t, date_t* date, byte& hours, byte& minutes, byte& seconds);
+
+// Returns the current date and time as epoch seconds,
+// or INVALID_EPOCH if SetDate() hasn't been called.
+epoch_t GetCurrentEpoch(void);
+
+// Daylight saving time rules.
+// Each returns true if DST is in effect at the given local standard time.
+// (So, when it returns true, show the time an hour later.)
+//
+// US: from 2:00 on the second Sunday in March to 2:00 on the first Sunday in November.
+byte IsDST_US(date_t* date, byte hours);
+// EU: from 1:00 UTC on the last Sunday in March to 1:00 UTC on the last Sunday in October.
+// Assumes Central European Time, where that's 2:00 local standard time.
+byte IsDST_EU(date_t* date, byte hours);
+
+
 #endif
\ No newline at end of file
@@ -0,0 +1,201 @@
+/* eeQueue.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_EEQUEUE
+
+#include <system.h>
+
+#include "eeQueue.h"
+#include "eeprom-tjw.h"
+
+
+#define EEQUEUE_RECORD_SIZE  (sizeof(QueueEntry) + 1)
+
+#if QUEUE_LENGTH > 120
+ #error "eeQueue.c - QUEUE_LENGTH must be well under the number of sequence values"
+#endif
+
+// Sequence numbers run from 0 to 0x7E, then start over.
+// 0x7F never appears, so an erased byte (0xFF) is never taken for a record.
+#define SEQ_MASK  0x7F
+#define SEQ_NONE  0x7F
+#define SEQ_POPPED  0x80
+
+
+// The ring slot and sequence number for the next record written.
+static byte nextSlot;
+static byte nextSeq;
+
+// The slot of the last entry popped, to be marked at the next commit.
+static byte poppedSlot;
+
+
+inline char SlotAddr(byte slot)
+{
+	return EEQUEUE_ADDR + slot * EEQUEUE_RECORD_SIZE;
+}
+
+inline byte NextSeq(byte seq)
+{
+	if (++seq == SEQ_NONE)
+		seq = 0;
+	return seq;
+}
+
+inline byte NextSlot(byte slot)
+{
+	if (++slot == QUEUE_LENGTH)
+		slot = 0;
+	return slot;
+}
+
+inline byte PrevSlot(byte slot)
+{
+	if (!slot)
+		slot = QUEUE_LENGTH;
+	return slot - 1;
+}
+
+// Returns the ring slot holding the given number of saved entries back from the newest.
+static byte SlotBack(byte count)
+{
+	byte slot = nextSlot;
+	while (count--)
+		slot = PrevSlot(slot);
+	return slot;
+}
+
+void InitEEQueue(void)
+{
+	byte slot;
+	byte seq;
+
+	ClearQueue();
+	eeQueueUnsaved = 0;
+	eeQueuePopPending = false;
+
+	// Find the newest record: the only one that isn't followed by the next in sequence.
+	byte newest = QUEUE_LENGTH;
+	byte newestSeq = SEQ_NONE;
+	for (slot = 0; slot < QUEUE_LENGTH; ++slot) {
+		seq = read_eeprom(SlotAddr(slot)) & SEQ_MASK;
+		if (seq != SEQ_NONE
+			&& (read_eeprom(SlotAddr(NextSlot(slot))) & SEQ_MASK) != NextSeq(seq)
+		) {
+			newest = slot;
+			newestSeq = seq;
+			break;
+		}
+	}
+
+	if (newest == QUEUE_LENGTH) {
+		// Nothing's been saved.
+		nextSlot = 0;
+		nextSeq = 0;
+		return;
+	}
+
+	nextSlot = NextSlot(newest);
+	nextSeq = NextSeq(newestSeq);
+
+	// Count back to the oldest record that's in sequence and after the last pop.
+	byte count = 0;
+	slot = newest;
+	seq = newestSeq;
+	while (count < QUEUE_LENGTH) {
+		byte stored = read_eeprom(SlotAddr(slot));
+		if ((stored & SEQ_MASK) != seq || (stored & SEQ_POPPED))
+			break;
+
+		++count;
+		slot = PrevSlot(slot);
+		if (seq == 0)
+			seq = SEQ_NONE;
+		--seq;
+	}
+
+	// Load them, oldest first.
+	slot = SlotBack(count);
+	while (count--) {
+		PrePushQueue();
+		read_eeprom_block(SlotAddr(slot) + 1, (char*) QueueTail(), sizeof(QueueEntry));
+		PushQueue();
+		slot = NextSlot(slot);
+	}
+}
+
+void EraseEEQueue(void)
+{
+	byte slot;
+	for (slot = 0; slot < QUEUE_LENGTH; ++slot)
+		write_eeprom(SlotAddr(slot), 0xFF);
+
+	ClearQueue();
+	eeQueueUnsaved = 0;
+	eeQueuePopPending = false;
+	nextSlot = 0;
+	nextSeq = 0;
+}
+
+void PrePushEEQueue(void)
+{
+	if (IsQueueFull())
+		PopEEQueue();
+}
+
+void PopEEQueue(void)
+{
+	if (queueCount > eeQueueUnsaved) {
+		// The head has been saved; it's the oldest of the saved ones.
+		poppedSlot = SlotBack(queueCount - eeQueueUnsaved);
+		eeQueuePopPending = true;
+	} else
+		// It was never saved, so there's nothing to undo.
+		--eeQueueUnsaved;
+
+	PopQueue();
+}
+
+void CommitEEQueue(void)
+{
+	// Mark the last pop; everything before it counts as popped too.
+	if (eeQueuePopPending) {
+		char addr = SlotAddr(poppedSlot);
+		write_eeprom(addr, read_eeprom(addr) | SEQ_POPPED);
+		eeQueuePopPending = false;
+	}
+
+	// Then save the new entries, oldest first.
+	// Only popped records get overwritten, since the ring is as long as the queue.
+	QueueEntry* entry = queueHead;
+	byte i;
+	for (i = queueCount - eeQueueUnsaved; i; --i)
+		entry = QueueIncrement(entry);
+
+	while (eeQueueUnsaved) {
+		char addr = SlotAddr(nextSlot);
+
+		// The entry first, then the sequence number that makes it valid.
+		write_eeprom_block(addr + 1, (char*) entry, sizeof(QueueEntry));
+		write_eeprom(addr, nextSeq);
+
+		nextSlot = NextSlot(nextSlot);
+		nextSeq = NextSeq(nextSeq);
+		entry = QueueIncrement(entry);
+		--eeQueueUnsaved;
+	}
+}
@@ -0,0 +1,112 @@
+/* eeQueue.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Keeps the queue from queue.h in EEPROM too, so what's in it survives a reset
+	or power loss - e.g. alarms waiting for a link to come back.
+
+	The RAM queue is still the one that's used; this mirrors it into a ring of
+	QUEUE_LENGTH records in EEPROM, starting at EEQUEUE_ADDR (from queue-consts.h).
+	Pushes and pops are only saved when CommitEEQueue() is called, so a burst of them
+	costs one commit: each new entry is written once, and all the pops together
+	cost a single byte.
+
+	Each record in EEPROM is a sequence byte followed by the entry.  Records are written
+	in order around the ring, each one's sequence byte last, so a record isn't there
+	until it's complete.  A pop is saved by setting the top bit of the last popped
+	record's sequence byte.  Nothing is written to the same place every time,
+	so the wear is spread over the whole ring.
+
+	If power fails during a commit, the queue comes back as it was before it,
+	or with some of the new entries and pops saved, in order - nothing is half-written.
+	An entry popped since the last commit may be delivered again after a reset.
+
+	At startup, InitEEQueue() reads one byte per record to find the saved entries,
+	then loads them into the RAM queue.
+
+	Use these calls in place of their queue.h equivalents:
+
+		InitEEQueue();
+		...
+		PrePushEEQueue();
+		QueueTail()->alarm = ALARM_OVERTEMP;
+		PushEEQueue();
+		CommitEEQueue();
+		...
+		if (!IsQueueEmpty() && SendAlarm(QueueHead()->alarm)) {
+			PopEEQueue();
+			CommitEEQueue();
+		}
+
+	Each commit blocks while its bytes are written (several ms each).
+	The space used is QUEUE_LENGTH * (sizeof(QueueEntry) + 1) bytes.
+*/
+
+#ifndef _EEQUEUE_H_
+#define _EEQUEUE_H_
+
+#include "queue.h"
+
+#ifdef IN_EEQUEUE
+ #define EEQUEUE_EXTERN
+#else
+ #define EEQUEUE_EXTERN  extern
+#endif
+
+#ifndef EEQUEUE_ADDR
+ #error "eeQueue.h - define EEQUEUE_ADDR in queue-consts.h"
+#endif
+
+
+// The number of entries at the tail of the RAM queue that haven't been saved yet.
+EEQUEUE_EXTERN byte eeQueueUnsaved;
+
+// True if there's a pop that hasn't been saved yet.
+EEQUEUE_EXTERN byte eeQueuePopPending;
+
+// Clears the RAM queue, then reloads it with the entries saved in EEPROM.
+// Call this once at startup, instead of ClearQueue().
+void InitEEQueue(void);
+
+// Empties the queue, in RAM and in EEPROM.
+// Call this once on a new device, since the EEPROM may hold anything at first.
+void EraseEEQueue(void);
+
+// Same as PrePushQueue(), but keeps track if the head is discarded.
+void PrePushEEQueue(void);
+
+// Same as PushQueue(); the new entry is saved at the next commit.
+inline void PushEEQueue(void)
+{
+	PushQueue();
+	++eeQueueUnsaved;
+}
+
+// Same as PopQueue(); the pop is saved at the next commit.
+void PopEEQueue(void);
+
+// Returns true if there are pushes or pops that haven't been saved.
+inline byte EEQueueNeedsCommit(void)
+{
+	return eeQueueUnsaved || eeQueuePopPending;
+}
+
+// Saves all the pushes and pops since the last commit.
+void CommitEEQueue(void);
+
+
+#endif
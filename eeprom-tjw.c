@@ -17,6 +17,7 @@
 
 #include <system.h>
 #include "eeprom-tjw.h"
+#include "profile.h"
 
 // Chips that can read and write their program ROM call it 'EEADRL' instead of 'EEADR'.
 // Compensate.
@@ -62,12 +63,12 @@ void write_eeprom(char addr, char data)
 	set_bit(eecon1, WREN);
 
 	// Disable interrupts while writing.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_EEPROM);
 	
 	eecon2 = 0x55;
 	eecon2 = 0xAA;
 	set_bit(eecon1, WR);                // write command
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_EEPROM);
 
 	clear_bit(eecon1, WREN);        // inhibit further writing
 }
@@ -84,6 +85,19 @@ void write_eeprom_block(char addr, char* buf, unsigned char len)
 		write_eeprom(addr++, *buf++);
 }
 
+byte write_eeprom_block_task(Task* t, char addr, char* buf, unsigned char len)
+{
+	TASK_BEGIN(t);
+	
+	for (t->i = 0; t->i < len; ++t->i) {
+		TASK_WAIT_UNTIL(t, is_eeprom_write_done());
+		write_eeprom(addr + t->i, buf[t->i]);
+	}
+	TASK_WAIT_UNTIL(t, is_eeprom_write_done());
+	
+	TASK_END(t);
+}
+
 void inc_eeprom_counter_long(char addr)
 {
 	unsigned long count;
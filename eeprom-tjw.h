@@ -18,12 +18,20 @@
 // Portable EEPROM read and write routines.
 // Addresses start at 0 for the first byte of EEPROM.
 
+#include "task.h"
+
 char read_eeprom(char addr);
 void write_eeprom(char addr, char data);
 
 void read_eeprom_block(char addr, char* buf, unsigned char len);
 void write_eeprom_block(char addr, char* buf, unsigned char len);
 
+// Task version of write_eeprom_block() (see task.h).
+// Lets other tasks run while each byte is being written, instead of spinning.
+// Done once the last byte has finished writing.
+// buf must stay unchanged until then.
+byte write_eeprom_block_task(Task* t, char addr, char* buf, unsigned char len);
+
 // Adds one to an unsigned long counter at the given EEPROM address.
 // Avoids overflow by bracketing the count at its max value.
 void inc_eeprom_counter_long(char addr);
@@ -45,4 +53,11 @@ inline void wait_eeprom_write(void)
 	// Wait for the write to complete.
 	while (!EE_PIR.EEIF)
 		clear_wdt();
-}
\ No newline at end of file
+}
+
+// Returns true if no EEPROM write is in progress, whether or not there's been one.
+// Doesn't wait, so can be used with TASK_WAIT_UNTIL instead of wait_eeprom_write().
+inline byte is_eeprom_write_done(void)
+{
+	return !eecon1.WR;
+}
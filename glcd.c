@@ -3,6 +3,7 @@
 
 #include <system.h>
 #include "glcd.h"
+#include "shadowRegs18.h"
 
 // Hard-coding the pin assignments here.  Should probably be pulled out into a consts file.
 #define LCD_CHAR_X_MARGIN  1
@@ -61,15 +62,24 @@ inline void delayLong(void)
 	}
 }
 
+// Returns the control lines for the given chip and register, and R/W.
+// Chip select is active low.
+inline byte glcd_ctl_bits(byte chip, byte reg, byte rw) {
+	byte result = chip? LCD_CS1_MASK: LCD_CS2_MASK;
+	if (reg)
+		result |= LCD_DI_MASK;
+	if (rw)
+		result |= LCD_RW_MASK;
+	return result;
+}
+
+#define LCD_SELECT_MASK  (LCD_RW_MASK | LCD_CS1_MASK | LCD_CS2_MASK | LCD_DI_MASK)
+
 void glcd_write(byte chip, byte reg, byte data) {
 	LCD_D_TRIS = 0;
-	LCD_CTL_PORT.LCD_RW_PIN = 0;
-	
-	// Chip select is active low.
-	LCD_CTL_PORT.LCD_CS1_PIN = chip;
-	LCD_CTL_PORT.LCD_CS2_PIN = !chip;
 	
-	LCD_CTL_PORT.LCD_DI_PIN = reg;
+	// R/W, chip selects, and D/I all at once.
+	SET_SHADOW(portc, LCD_CTL_PORT, glcd_ctl_bits(chip, reg, 0), LCD_SELECT_MASK);
 	
 	LCD_D_PORT = data;
 	delayLong();
@@ -82,13 +92,8 @@ byte glcd_read(byte chip, byte reg) {
 	byte d;
   
 	LCD_D_TRIS = 0xFF;
-	LCD_CTL_PORT.LCD_RW_PIN = 1;
 
-	// Chip select is active low.
-	LCD_CTL_PORT.LCD_CS1_PIN = chip;
-	LCD_CTL_PORT.LCD_CS2_PIN = !chip;
-	
-	LCD_CTL_PORT.LCD_DI_PIN = reg;
+	SET_SHADOW(portc, LCD_CTL_PORT, glcd_ctl_bits(chip, reg, 1), LCD_SELECT_MASK);
 	
 	delayLong();
 	LCD_CTL_PORT.LCD_E_PIN = 1;
@@ -110,17 +115,15 @@ void glcd_write_wait(byte chip, byte reg, byte data) {
 	glcd_wait(chip);
 }
 
-void glcd_init(void) {
-	
+// The parts of initialization before and after the reset pulse.
+static void glcd_init_ports(void) {
 	LCD_D_TRIS = 0xFF;  // Set the data lines to inputs for now.
 	LCD_CTL_TRIS &= (~LCD_CTL_MASK);  // All the control lines are outputs.
-	LCD_CTL_PORT &= ~(LCD_RW_MASK | LCD_DI_MASK | LCD_E_MASK | LCD_RST_MASK);  // R/W, D/I, E, RST low
-	LCD_CTL_PORT |= (LCD_CS1_MASK | LCD_CS2_MASK);  // CS1, CS2 high
-	
-	delay_ms(10);
-	LCD_CTL_PORT.LCD_RST_PIN = 1;
-	delay_ms(50);	
-	
+	// CS1, CS2 high; R/W, D/I, E, RST low.
+	SET_SHADOW_BITS(portc, LCD_CTL_PORT, LCD_CS1_MASK | LCD_CS2_MASK, LCD_RW_MASK | LCD_DI_MASK | LCD_E_MASK | LCD_RST_MASK);
+}
+
+static void glcd_init_chips(void) {
 	glcd_wait(0);
 	glcd_wait(1);
 	glcd_write_wait(0, LCD_INST, LCD_POWERON(1));
@@ -131,6 +134,30 @@ void glcd_init(void) {
 	glcd_clear(0xAA);
 }
 
+void glcd_init(void) {
+	glcd_init_ports();
+	
+	delay_ms(10);
+	LCD_CTL_PORT.LCD_RST_PIN = 1;
+	delay_ms(50);	
+	
+	glcd_init_chips();
+}
+
+byte glcd_init_task(Task* t) {
+	TASK_BEGIN(t);
+	
+	glcd_init_ports();
+	
+	TASK_SLEEP_MS(t, 10);
+	LCD_CTL_PORT.LCD_RST_PIN = 1;
+	TASK_SLEEP_MS(t, 50);
+	
+	glcd_init_chips();
+	
+	TASK_END(t);
+}
+
 
 #define CACHE_EMPTY 255 
 static byte cache_chip = CACHE_EMPTY;
@@ -6,6 +6,7 @@
 #ifndef __GLCD_H
 #define __GLCD_H  1
 
+#include "task.h"
 #include "types-tjw.h"
 
 
@@ -27,6 +28,10 @@
  *             set display line to zero */
 void glcd_init(void);
 
+/* glcd_init_task(): same as glcd_init(), but sleeps through the reset
+ *             delays instead of blocking.  See task.h. */
+byte glcd_init_task(Task* t);
+
 /* glcd_clear(): clear the entire lcd to the given value */
 void glcd_clear(byte data);
 
@@ -0,0 +1,31 @@
+// CapSense-consts.h
+// For the host benchmarks (bench.cpp).
+
+
+#ifndef __CAPSENSE_CONSTS
+#define __CAPSENSE_CONSTS
+
+// The channels in use, as a mask.
+#define CAPSENSE_CHANNEL0  0x01
+#define CAPSENSE_CHANNEL1  0x02
+#define CAPSENSE_CHANNEL2  0x04
+#define CAPSENSE_CHANNEL3  0x08
+#define CAPSENSE_CHANNELS  (CAPSENSE_CHANNEL0 | CAPSENSE_CHANNEL1 | CAPSENSE_CHANNEL2 | CAPSENSE_CHANNEL3)
+#define FIRST_CAPSENSE_CHANNEL  0
+#define LAST_CAPSENSE_CHANNEL  3
+
+// Readings are averaged over this many samples.
+#define FILTER_LENGTH  4
+
+// The lowest "pressed" threshold, whatever the baseline.
+#define CS_MIN_THRESHOLD  100
+
+// Polls with no button down before another press is taken.
+#define DEBOUNCE_POLLS  20
+
+// Where csThresholds is kept.
+#define CAPSENSE_EEPROM_ADDR  0
+#define CAPSENSE_EEPROM_LEN  MAX_CAPSENSE_CHANNELS
+
+
+#endif
@@ -0,0 +1,634 @@
+/* bench.cpp
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Runs the library's hot paths on a PC, and reports how fast they are,
+	so a change that slows one down shows up without hardware.
+
+	Build from the library directory, with the host system.h (see there):
+
+		g++ -std=c++17 -O2 -funsigned-char -D_PIC16F886 -Ihost -o bench \
+			host/bench.cpp -x c++ queue.c pqueue.c crc_8bit.c log.c dayTime.c uiSeconds.c uiTime.c \
+			buttons.c CapSense.c eeprom-tjw.c mem-tjw.c timerWheel.c task.c serialPrintf.c
+
+	Then:
+
+		./bench                  prints the results
+		./bench -w base.txt      also saves them as a baseline
+		./bench base.txt         compares against a saved baseline;
+		                         exits with 1 if anything got slower by more than 25%,
+		                         or its estimate went up
+
+	For each benchmark, the output shows the number of operations timed,
+	host nanoseconds per operation, and estimated PIC instruction cycles per operation
+	(see "PIC cycle estimates" below).
+
+	Host times show that an operation has become more or less work, but not what it costs
+	on a PIC, so only compare them against a baseline saved on the same PC, with the same compiler.
+	The estimates are worked out from a table of costs, so they carry over between PCs.
+*/
+
+#include <system.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../queue.h"
+#include "../pqueue.h"
+#include "../crc_8bit.h"
+#include "../fixed16.h"
+#include "../log.h"
+#include "../dayTime.h"
+#include "../buttons.h"
+#include "../CapSense.h"
+#include "../mem-tjw.h"
+#include "../timerWheel.h"
+#include "../serialPrintf.h"
+
+
+// How long to run each benchmark, in ns, split over this many trials.
+#define BENCH_NS  250000000ULL
+#define BENCH_TRIALS  5
+
+// A slower result than the baseline by more than this percentage is a regression.
+#define REGRESSION_PERCENT  25
+
+#define MAX_BENCHMARKS  16
+
+
+// Results are summed in here, so the optimizer can't discard the work.
+volatile unsigned long benchSink;
+
+
+//====================================================================
+// PIC cycle estimates
+//
+// Host time says little about a PIC, so each benchmark also adds up what its operations
+// would cost there, in picCycles.  The costs below are counted by hand from the C,
+// following these rules for BoostC on a PIC16 (one cycle per instruction, two per jump),
+// and the counts that depend on the data - heap levels, digits, expired timers and the like -
+// are measured as the benchmark runs.  Delays from the host system.h are added exactly.
+//
+// So an estimate is only as good as its entry here: good to a third or so, and it has to be
+// counted again when the code behind it changes.  Regressions are caught by the host times;
+// for exact cycle counts, use the TEST_* mains in the modules with the simulator.
+
+#define PIC_OP8  2  // an 8-bit operation on a variable: load, operate, store
+#define PIC_OP16  5  // a 16-bit move, add, subtract, or shift by one
+#define PIC_OP32  10  // the same, 32 bits
+#define PIC_TEST  3  // an 8-bit test or compare, and the branch
+#define PIC_TEST16  7  // a 16-bit compare, and the branch
+#define PIC_TEST32  12  // a 32-bit compare, and the branch
+#define PIC_INDEX  4  // reaching an array element or pointer target through FSR
+#define PIC_ROM  10  // a byte from a ROM table: call, computed jump, retlw
+#define PIC_CALL  6  // a call and return, passing a byte or two
+#define PIC_MUL16  200  // BoostC's 16 x 16 multiply: 16 rounds of test, add, and shift
+#define PIC_DIV16  300  // BoostC's 16 / 16 divide: 16 rounds of shift, compare, and subtract
+#define PIC_SEND  (PIC_TEST + PIC_OP8)  // WriteSerial(), with the transmitter ready
+
+// Queue: PrePushQueue()'s full test, storing the entry, and QueueIncrement() on the tail.
+#define PIC_QUEUE_PUSH  (2 * PIC_CALL + PIC_TEST + PIC_INDEX + 2 * PIC_OP8 + 2 * PIC_OP16 + PIC_TEST16)
+#define PIC_QUEUE_POP  (PIC_CALL + PIC_INDEX + 2 * PIC_OP8 + 2 * PIC_OP16 + PIC_TEST16)
+
+// Priority queue: finding and filling the slot, then each level sifted through.
+#define PIC_PQUEUE_PUSH  (PIC_CALL + 3 * PIC_INDEX + PIC_OP16 + 3 * PIC_OP8)
+#define PIC_PQUEUE_PUSH_LEVEL  (3 * PIC_OP8 + 3 * PIC_INDEX + PIC_OP16 + PIC_TEST16)
+#define PIC_PQUEUE_POP  (PIC_CALL + 4 * PIC_INDEX + 3 * PIC_OP8 + PIC_OP16 + PIC_TEST)
+#define PIC_PQUEUE_POP_LEVEL  (4 * PIC_OP8 + 2 * PIC_TEST + 5 * PIC_INDEX + 2 * PIC_TEST16)
+
+// crc8(), with the default table: an XOR and a table read.
+#define PIC_CRC8  (PIC_CALL + 2 * PIC_OP8 + PIC_ROM)
+
+// The fixed16 benchmark's mix: two shifts by 4 and a multiply, fixedTenths()'s absolute value
+// and multiply by 10, rounding, and a reciprocal's divide.
+#define PIC_FIXED16_MIX  (8 * PIC_OP16 + 2 * PIC_MUL16 + 4 * PIC_OP16 + 2 * PIC_TEST16 + 4 * PIC_OP8)
+#define PIC_FIXED16_RECIPROCAL  (PIC_DIV16 + PIC_OP16)
+
+// log2_us(): a shift per leading zero, then two table reads and an interpolating multiply.
+#define PIC_LOG2  (PIC_CALL + 2 * PIC_ROM + PIC_MUL16 + 6 * PIC_OP16 + 4 * PIC_OP8)
+#define PIC_LOG2_SHIFT  (2 * PIC_TEST + PIC_OP16 + PIC_OP8)
+
+// DecodeEpoch(): TakeUnits() costs a 32-bit compare, shift, and half a subtract per quotient bit,
+// after shifting the unit into place.  There are 16 + 5 + 6 bits, then 14 + 5 more in
+// DateFromDayNumber(), plus the years in the 4-year cycle and a DaysInMonth() per month.
+#define PIC_TAKE_UNITS_BIT  (PIC_TEST32 + PIC_OP32 + PIC_OP32 / 2 + PIC_OP16 + PIC_TEST)
+#define PIC_TAKE_UNITS_SETUP_BIT  (PIC_OP32 + PIC_TEST)
+#define PIC_DECODE_EPOCH  (5 * PIC_CALL + 46 * PIC_TAKE_UNITS_BIT + 41 * PIC_TAKE_UNITS_SETUP_BIT \
+	+ 3 * (PIC_TEST16 + PIC_OP16) + 8 * PIC_OP8)
+#define PIC_DECODE_EPOCH_MONTH  (PIC_CALL + PIC_ROM + 2 * PIC_TEST + PIC_TEST16 + PIC_OP16)
+
+// CheckButtons() per button, and GetButton()'s search.
+#define PIC_BUTTONS  (PIC_CALL + 2 * PIC_OP8)
+#define PIC_BUTTONS_EACH  (3 * PIC_TEST + 3 * PIC_OP8 + PIC_INDEX)
+#define PIC_GET_BUTTON  (PIC_CALL + PIC_TEST + 4 * (PIC_TEST + PIC_OP8))
+
+// CapSenseISR() and CapSenseISRDone(): uiTime's share, the threshold, the running average
+// (a shift, not a divide, since FILTER_LENGTH is a power of 2), the press tests,
+// the bin's maximum, and starting the next channel.
+#define PIC_CAPSENSE  (3 * PIC_CALL + 30 + 4 * PIC_INDEX + 6 * PIC_TEST16 + 8 * PIC_OP16 \
+	+ 8 * PIC_TEST + 10 * PIC_OP8 + 2 * PIC_OP16)
+
+// TimerWheelTick(): advancing, and taking the current slot, then for each timer expiring,
+// rescheduling it with FileTimer() and putting it on the ready list.
+// GetExpiredTimer() costs a pass per ready timer, and one more to find the list empty.
+#define PIC_WHEEL_TICK  (PIC_CALL + PIC_OP16 + 2 * PIC_TEST + 2 * PIC_INDEX + 2 * PIC_OP8 + PIC_TEST)
+#define PIC_WHEEL_EXPIRY  (2 * PIC_CALL + 6 * PIC_INDEX + PIC_TEST16 + 2 * PIC_OP16 + 3 * PIC_TEST16 \
+	+ 4 * PIC_OP8 + 3 * PIC_TEST)
+#define PIC_GET_EXPIRED  (PIC_CALL + 2 * PIC_OP8 + PIC_TEST)
+#define PIC_GET_EXPIRED_EACH  (2 * PIC_INDEX + 3 * PIC_OP8 + 3 * PIC_TEST)
+
+// copyBytes() per byte, in C on a PIC16: the two pointers take turns in the one FSR.
+#define PIC_COPY_BYTE  (2 * PIC_INDEX + 2 * PIC_OP16 + PIC_OP8)
+
+// SerialPrintf(): per character of the format sent as is, per conversion, and inside ToBcd()
+// per leading zero bit and per significant bit (five BCD bytes adjusted, then shifted),
+// and per digit or padding character sent.
+#define PIC_PRINTF  (PIC_CALL + 2 * PIC_OP32)
+#define PIC_PRINTF_LITERAL  (PIC_ROM + 2 * PIC_TEST + PIC_OP8 + PIC_SEND)
+#define PIC_PRINTF_CONVERSION  (5 * PIC_ROM + 10 * PIC_TEST + 6 * PIC_OP8 + 2 * PIC_OP32 + 3 * PIC_CALL \
+	+ 5 * (PIC_INDEX + PIC_OP8))
+#define PIC_PRINTF_ZERO_BIT  (PIC_TEST + PIC_OP32 + PIC_OP8 + PIC_TEST)
+#define PIC_PRINTF_BIT  (5 * (PIC_INDEX + 2 * PIC_TEST + 2 * PIC_OP8 + PIC_INDEX) + PIC_OP32 \
+	+ 5 * (2 * PIC_INDEX + 3 * PIC_OP8))
+#define PIC_PRINTF_DIGIT  (PIC_INDEX + 3 * PIC_OP8 + PIC_TEST + PIC_SEND)
+#define PIC_PRINTF_HEX_DIGIT  (6 * PIC_OP32 + 2 * PIC_TEST + 2 * PIC_OP8)  // a variable shift, counting or sending
+
+// Added up by the benchmarks, in a run of their own, so the counting isn't timed.
+static unsigned long long picCycles;
+static bool estimating;
+
+#define PIC_COST(cycles)  { if (estimating) picCycles += (cycles); }
+
+// Returns how many levels down the heap the given index is.
+static byte HeapLevel(byte index)
+{
+	byte level = 0;
+	while (index) {
+		index = (index - 1) >> 1;
+		++level;
+	}
+	return level;
+}
+
+// Returns where the given slot is in the heap.
+static byte HeapIndexOf(byte slot)
+{
+	byte i;
+	for (i = 0; i < pqCount; ++i)
+		if (pqHeap[i] == slot)
+			return i;
+	return 0;
+}
+
+// Returns the number of significant bits in x.
+static byte SignificantBits(unsigned long x)
+{
+	byte bits = 0;
+	while (x) {
+		x >>= 1;
+		++bits;
+	}
+	return bits;
+}
+
+
+//====================================================================
+// The benchmarks
+//
+// Each one has an init function, run once, and a run function, run repeatedly,
+// which returns the number of operations it did, and adds their estimated cost with PIC_COST.
+
+static void NoInit(void)
+{
+}
+
+static void InitQueue(void)
+{
+	ClearQueue();
+}
+
+static unsigned long RunQueue(void)
+{
+	byte i;
+	for (i = 0; i < 128; ++i) {
+		PrePushQueue();
+		QueueTail()->b = i;
+		PushQueue();
+
+		if (i & 1) {
+			benchSink += QueueHead()->b;
+			PopQueue();
+		}
+	}
+	while (!(IsQueueEmpty())) {
+		benchSink += QueueHead()->b;
+		PopQueue();
+	}
+
+	// One push and one pop each.
+	PIC_COST(128 * (PIC_QUEUE_PUSH + PIC_QUEUE_POP));
+	return 2 * 128;
+}
+
+static void InitPQueueBench(void)
+{
+	ClearPQueue();
+}
+
+// Pops the head, and counts the cost of the levels its replacement sifted down.
+static void PopPQueueCounted(void)
+{
+	byte last = pqHeap[pqCount - 1];
+	PopPQueue();
+	PIC_COST(PIC_PQUEUE_POP);
+	if (pqCount)
+		PIC_COST((HeapLevel(HeapIndexOf(last)) + 1) * PIC_PQUEUE_POP_LEVEL);
+}
+
+static unsigned long RunPQueue(void)
+{
+	// Keeps it about half full, with scattered deadlines.
+	unsigned short now = 0;
+	byte i;
+	for (i = 0; i < 128; ++i) {
+		byte slot = pqHeap[pqCount];
+		PQueueTail()->command = i;
+		PushPQueue(now + ((i * 37) & 0x3F));
+		PIC_COST(PIC_PQUEUE_PUSH
+			+ (HeapLevel(pqCount - 1) - HeapLevel(HeapIndexOf(slot)) + 1) * PIC_PQUEUE_PUSH_LEVEL);
+
+		if (pqCount > PQUEUE_LENGTH / 2) {
+			benchSink += PQueueHead()->command;
+			PopPQueueCounted();
+			now += 8;
+		}
+	}
+	while (!IsPQueueEmpty()) {
+		benchSink += PQueueHead()->command;
+		PopPQueueCounted();
+	}
+
+	// One push and one pop each.
+	return 2 * 128;
+}
+
+static unsigned long RunCrc8(void)
+{
+	unsigned short i;
+	crc8Init();
+	for (i = 0; i < 256; ++i)
+		crc8((byte) i);
+	benchSink += crc;
+	PIC_COST(256 * PIC_CRC8);
+	return 256;
+}
+
+static unsigned long RunFixed16(void)
+{
+	unsigned short i;
+	for (i = 0; i < 256; ++i) {
+		fixed16 f = makeFixed((byte) i >> 2, (byte) i);
+		fixed16 product = (f >> 4) * (f >> 4);
+		signed char integral;
+		fixedIntegralTo(product, integral);
+		benchSink += fixedTenths(f) + fixedRoundToByte(f) + integral;
+		PIC_COST(PIC_FIXED16_MIX);
+		if (fixedIntegral(f)) {
+			benchSink += fixedReciprocal(f);
+			PIC_COST(PIC_FIXED16_RECIPROCAL);
+		}
+	}
+	return 256;
+}
+
+static unsigned long RunLog2(void)
+{
+	unsigned short i;
+	for (i = 1; i <= 256; ++i) {
+		unsigned short x = i * 251;
+		benchSink += log2_us(x);
+		PIC_COST(PIC_LOG2 + (16 - SignificantBits(x)) * PIC_LOG2_SHIFT);
+	}
+	return 256;
+}
+
+static unsigned long RunDayTime(void)
+{
+	// Converts dates and times to their fields for display.
+	date_t date;
+	byte hours, minutes, seconds;
+	unsigned short i;
+	for (i = 0; i < 256; ++i) {
+		DecodeEpoch((epoch_t) i * 1234567UL, &date, hours, minutes, seconds);
+		benchSink += date.day + date.weekday + hours + minutes + seconds;
+		PIC_COST(PIC_DECODE_EPOCH + date.month * PIC_DECODE_EPOCH_MONTH);
+	}
+	return 256;
+}
+
+static void InitButtonsBench(void)
+{
+	InitButtons();
+}
+
+static unsigned long RunButtons(void)
+{
+	// Bouncy presses on each button in turn.
+	// The buttons are active low, so they're down when their bits are clear.
+	unsigned short i;
+	for (i = 0; i < 256; ++i) {
+		byte pressing = 1 << ((i >> 6) & 3);
+		if ((i & 0x3F) < 8)
+			portb = (i & 1) ? ~pressing : 0xFF;
+		else if ((i & 0x3F) < 56)
+			portb = ~pressing;
+		else
+			portb = 0xFF;
+
+		CheckButtons();
+		benchSink += GetButton();
+	}
+	PIC_COST(256 * (PIC_BUTTONS + (LAST_BTN - FIRST_BTN + 1) * PIC_BUTTONS_EACH + PIC_GET_BUTTON));
+	return 256;
+}
+
+static void InitCapSenseBench(void)
+{
+	InitCapSense();
+}
+
+static unsigned long RunCapSense(void)
+{
+	// Readings drift around a baseline, with a press every so often.
+	unsigned short i;
+	for (i = 0; i < 256; ++i) {
+		unsigned short reading = 3000 + (i & 0x1F);
+		if ((i & 0xC0) == 0xC0)
+			reading -= 500;
+		LOBYTE(tmr1l, reading);
+		HIBYTE(tmr1h, reading);
+
+		intcon.T0IF = 1;
+		CapSenseISR();
+		CapSenseISRDone();
+	}
+	benchSink += GetCapSenseButton();
+	PIC_COST(256 * PIC_CAPSENSE);
+	return 256;
+}
+
+static void InitTimerWheelBench(void)
+{
+	byte id;
+	InitTimerWheel();
+	for (id = 0; id < NUM_TIMERS; ++id)
+		StartTimer(id, 1 + id * 7, 3 + id * 37);
+}
+
+static unsigned long RunTimerWheel(void)
+{
+	// Ticks, and collects whatever expired.
+	unsigned short i;
+	for (i = 0; i < 256; ++i) {
+		TimerWheelTick();
+		PIC_COST(PIC_WHEEL_TICK + PIC_GET_EXPIRED);
+		byte id;
+		while ((id = GetExpiredTimer()) != NO_TIMER) {
+			benchSink += id;
+			PIC_COST(PIC_WHEEL_EXPIRY + PIC_GET_EXPIRED + PIC_GET_EXPIRED_EACH);
+		}
+	}
+	return 256;
+}
+
+static char memSrc[256];
+static char memDst[256];
+
+static unsigned long RunCopyBytes(void)
+{
+	// Per byte copied.
+	copyBytes(memDst, memSrc, sizeof(memDst));
+	benchSink += memDst[sizeof(memDst) - 1];
+	PIC_COST(sizeof(memDst) * PIC_COPY_BYTE);
+	return sizeof(memDst);
+}
+
+static void InitSerialPrintfBench(void)
+{
+	// The transmitter always has room.
+	pir1.TXIF = 1;
+}
+
+// Counts the cost of a SerialPrintf() with one conversion, given the characters of the format
+// sent as is, the value converted, and the characters sent for it.
+static void CountPrintf(byte literals, unsigned long converted, byte sent)
+{
+	byte bits = SignificantBits(converted);
+	PIC_COST(PIC_PRINTF + literals * PIC_PRINTF_LITERAL + PIC_PRINTF_CONVERSION
+		+ (32 - bits) * PIC_PRINTF_ZERO_BIT + bits * PIC_PRINTF_BIT + sent * PIC_PRINTF_DIGIT);
+}
+
+static unsigned long RunSerialPrintf(void)
+{
+	// Formats a line of readings, as an app would report them; per call.
+	unsigned short i;
+	for (i = 0; i < 64; ++i) {
+		unsigned short adc = i * 1021;
+		fixed16 temperature = i * 97 - 3000;
+		unsigned long up = (unsigned long) i * 86413;
+		SerialPrintf("ADC %4u  ", adc);
+		SerialPrintf("T=%.1f C  ", temperature);
+		SerialPrintf("flags %02x\r\n", i);
+		SerialPrintfLong("up %lu s\r\n", up);
+		benchSink += txreg;
+
+		if (estimating) {
+			char text[16];
+			CountPrintf(6, adc, snprintf(text, sizeof(text), "%4u", adc));
+			// The integral part goes through ToBcd(); the tenths are worked out as digits.
+			signed short whole = temperature < 0 ? -temperature : temperature;
+			CountPrintf(6, whole >> 8, snprintf(text, sizeof(text), "%.1f", temperature / 256.0));
+			PIC_COST(PIC_PRINTF + 8 * PIC_PRINTF_LITERAL + PIC_PRINTF_CONVERSION
+				+ 4 * PIC_PRINTF_HEX_DIGIT + 2 * PIC_PRINTF_DIGIT);
+			CountPrintf(7, up, snprintf(text, sizeof(text), "%lu", up));
+		}
+	}
+	return 4 * 64;
+}
+
+
+typedef struct {
+	const char* name;
+	void (*init)(void);
+	unsigned long (*run)(void);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+	{ "queue", InitQueue, RunQueue },
+	{ "pqueue", InitPQueueBench, RunPQueue },
+	{ "crc8", NoInit, RunCrc8 },
+	{ "fixed16", NoInit, RunFixed16 },
+	{ "log2", NoInit, RunLog2 },
+	{ "dayTime", NoInit, RunDayTime },
+	{ "buttons", InitButtonsBench, RunButtons },
+	{ "CapSenseISR", InitCapSenseBench, RunCapSense },
+	{ "timerWheel", InitTimerWheelBench, RunTimerWheel },
+	{ "copyBytes", NoInit, RunCopyBytes },
+	{ "serialPrintf", InitSerialPrintfBench, RunSerialPrintf },
+};
+
+#define NUM_BENCHMARKS  (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+
+//====================================================================
+// The runner
+
+typedef struct {
+	unsigned long long ops;
+	double nsPerOp;
+	double picCyclesPerOp;
+} BenchResult;
+
+static unsigned long long NowNs(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long long) t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+static void RunBenchmark(const Benchmark* b, BenchResult* result)
+{
+	b->init();
+
+	// Once to warm up, and add up the estimate.
+	unsigned long long startCycles = hostCycles;
+	picCycles = 0;
+	estimating = true;
+	unsigned long estimateOps = b->run();
+	estimating = false;
+
+	// Delays are PIC cycles too.
+	result->picCyclesPerOp = (double) (picCycles + hostCycles - startCycles) / estimateOps;
+
+	// The fastest of several trials is the least disturbed by whatever else the PC is doing.
+	byte trial;
+	result->ops = 0;
+	result->nsPerOp = 0;
+	for (trial = 0; trial < BENCH_TRIALS; ++trial) {
+		unsigned long long ops = 0;
+		unsigned long long start = NowNs();
+		unsigned long long elapsed;
+		do {
+			ops += b->run();
+			elapsed = NowNs() - start;
+		} while (elapsed < BENCH_NS / BENCH_TRIALS);
+
+		double nsPerOp = (double) elapsed / ops;
+		if (trial == 0 || nsPerOp < result->nsPerOp)
+			result->nsPerOp = nsPerOp;
+		result->ops += ops;
+	}
+
+}
+
+// Reads a baseline saved with -w into names and results.
+// Returns the number read.
+static int ReadBaseline(const char* path, char names[][32], BenchResult* results)
+{
+	FILE* f = fopen(path, "r");
+	if (!f) {
+		perror(path);
+		exit(2);
+	}
+
+	int count = 0;
+	while (count < MAX_BENCHMARKS
+		&& fscanf(f, "%31s %lf %lf", names[count], &results[count].nsPerOp, &results[count].picCyclesPerOp) == 3
+	)
+		++count;
+
+	fclose(f);
+	return count;
+}
+
+int main(int argc, char** argv)
+{
+	const char* savePath = 0;
+	const char* basePath = 0;
+
+	int i;
+	for (i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-w") && i + 1 < argc)
+			savePath = argv[++i];
+		else if (argv[i][0] != '-')
+			basePath = argv[i];
+		else {
+			fprintf(stderr, "usage: %s [-w save.txt] [baseline.txt]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	char baseNames[MAX_BENCHMARKS][32];
+	BenchResult baseResults[MAX_BENCHMARKS];
+	int baseCount = 0;
+	if (basePath)
+		baseCount = ReadBaseline(basePath, baseNames, baseResults);
+
+	BenchResult results[NUM_BENCHMARKS];
+	unsigned b;
+	for (b = 0; b < NUM_BENCHMARKS; ++b)
+		RunBenchmark(&benchmarks[b], &results[b]);
+
+	int regressions = 0;
+	printf("%-12s %12s %10s %12s", "benchmark", "ops", "ns/op", "~PIC cyc/op");
+	if (baseCount)
+		printf(" %10s", "vs. base");
+	printf("\n");
+
+	for (b = 0; b < NUM_BENCHMARKS; ++b) {
+		BenchResult* r = &results[b];
+		printf("%-12s %12llu %10.2f %12.1f", benchmarks[b].name,
+			r->ops, r->nsPerOp, r->picCyclesPerOp);
+
+		for (i = 0; i < baseCount; ++i)
+			if (!strcmp(baseNames[i], benchmarks[b].name)) {
+				double change = 100.0 * (r->nsPerOp - baseResults[i].nsPerOp) / baseResults[i].nsPerOp;
+				printf(" %+9.1f%%", change);
+
+				// The estimate doesn't vary from run to run, so any rise is worth a look.
+				if (change > REGRESSION_PERCENT || r->picCyclesPerOp > baseResults[i].picCyclesPerOp * 1.001) {
+					printf("  REGRESSION");
+					++regressions;
+				}
+			}
+		printf("\n");
+	}
+
+	if (savePath) {
+		FILE* f = fopen(savePath, "w");
+		if (!f) {
+			perror(savePath);
+			return 2;
+		}
+		for (b = 0; b < NUM_BENCHMARKS; ++b)
+			fprintf(f, "%s %.3f %.3f\n", benchmarks[b].name, results[b].nsPerOp, results[b].picCyclesPerOp);
+		fclose(f);
+	}
+
+	return regressions ? 1 : 0;
+}
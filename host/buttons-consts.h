@@ -0,0 +1,28 @@
+// buttons-consts.h
+// For the host benchmarks (bench.cpp).
+
+
+#ifndef __BUTTONS_CONSTS
+#define __BUTTONS_CONSTS
+
+#define BUTTON_PORT  portb
+#define BUTTON_TRIS  trisb
+
+#define PREV_BTN  0
+#define NEXT_BTN  1
+#define OK_BTN  2
+#define CANCEL_BTN  3
+
+#define PREV_BTN_MASK  (1 << PREV_BTN)
+#define NEXT_BTN_MASK  (1 << NEXT_BTN)
+#define OK_BTN_MASK  (1 << OK_BTN)
+#define CANCEL_BTN_MASK  (1 << CANCEL_BTN)
+#define ALL_BTNS_MASK  (PREV_BTN_MASK | NEXT_BTN_MASK | OK_BTN_MASK | CANCEL_BTN_MASK)
+
+#define FIRST_BTN  PREV_BTN
+#define LAST_BTN  CANCEL_BTN
+
+#define MIN_DOWNS  40
+
+
+#endif
@@ -0,0 +1,13 @@
+// pqueue-consts.h
+// For the host benchmarks (bench.cpp).
+
+#ifndef __PQUEUE_CONSTS
+#define __PQUEUE_CONSTS
+
+typedef struct {
+	unsigned char command;
+} PQueueEntry;
+
+#define PQUEUE_LENGTH  16
+
+#endif
@@ -0,0 +1,13 @@
+// queue-consts.h
+// For the host benchmarks (bench.cpp).
+
+#ifndef __QUEUE_CONSTS
+#define __QUEUE_CONSTS
+
+typedef struct {
+	unsigned char b;
+} QueueEntry;
+
+#define QUEUE_LENGTH  8
+
+#endif
@@ -0,0 +1,10 @@
+// serial-consts.h
+// For the host benchmarks (bench.cpp), which send formatted output to txreg.
+
+#ifndef __SERIAL_CONSTS
+#define __SERIAL_CONSTS
+
+#define SERIAL_BAUD  9600
+
+
+#endif
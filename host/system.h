@@ -0,0 +1,246 @@
+/* system.h - host build
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Stands in for BoostC's <system.h> when building the library on a PC,
+	so modules can be run and benchmarked without hardware (see bench.cpp).
+
+	Provides the BoostC built-ins the library uses (bit, rom, MAKESHORT, set_bit,
+	delay_ms, etc.), and the special function registers of a PIC16F886 as plain
+	variables, with their bits by name.  Nothing happens when they're written,
+	except for a minimal model of the data EEPROM; drive inputs like TMR1 and
+	the ports from the host code.
+
+	Modules are compiled as C++, since they use references and templates:
+
+		g++ -std=c++17 -O2 -x c++ -funsigned-char -D_PIC16F886 -Ihost ...
+
+	-funsigned-char matches BoostC, where char is unsigned.
+	Note that long is 64 bits here rather than 32, so code that counts on it wrapping
+	around will act differently.
+*/
+
+#ifndef __HOST_SYSTEM_H
+#define __HOST_SYSTEM_H
+
+#define HOST_BUILD
+
+#ifndef _PIC16F886
+ #error "host/system.h - only the PIC16F886 registers are modeled; define _PIC16F886"
+#endif
+
+
+//====================================================================
+// Types and keywords
+
+typedef bool bit;
+
+// Program memory is just constant data here.
+// Braced tables have to be declared with ROM_TABLE (types-tjw.h).
+#define rom  const
+#define ROM_TABLE(type, name)  const type name[]
+
+// Makes a 16-bit value from two bytes.
+#define MAKESHORT(dst, lo, hi)  ((dst) = (unsigned short)(((unsigned char)(hi) << 8) | (unsigned char)(lo)))
+#define LOBYTE(dst, src)  ((dst) = (unsigned char)(src))
+#define HIBYTE(dst, src)  ((dst) = (unsigned char)((unsigned short)(src) >> 8))
+
+// BoostC's <stdlib.h> has these.
+// The result is the first argument's type, so mixing in a constant works as it does there.
+template <class T, class U>
+inline T min(T a, U b)
+{
+	return a < (T) b ? a : (T) b;
+}
+
+template <class T, class U>
+inline T max(T a, U b)
+{
+	return a > (T) b ? a : (T) b;
+}
+
+
+//====================================================================
+// Cycle accounting
+
+// The oscillator frequency, in Hz; matches uiTime.h's default.
+#ifndef HOST_FOSC
+ #define HOST_FOSC  4000000
+#endif
+
+// Instruction cycles spent in the delay functions and sleep().
+// The delays return immediately; they just add to this.
+inline unsigned long long hostCycles;
+
+inline void delay_us(unsigned char us)  { hostCycles += (unsigned long long) us * (HOST_FOSC / 4000000); }
+inline void delay_10us(unsigned char n)  { hostCycles += (unsigned long long) n * (HOST_FOSC / 400000); }
+inline void delay_ms(unsigned char ms)  { hostCycles += (unsigned long long) ms * (HOST_FOSC / 4000); }
+inline void delay_s(unsigned char s)  { hostCycles += (unsigned long long) s * (HOST_FOSC / 4); }
+
+inline void clear_wdt(void)  { ++hostCycles; }
+inline void nop(void)  { ++hostCycles; }
+inline void sleep(void)  { ++hostCycles; }
+
+
+//====================================================================
+// Special function registers
+
+// Bit numbers, for set_bit() and friends.
+enum {
+	// intcon
+	RBIF = 0, INTF = 1, T0IF = 2, TMR0IF = 2, RBIE = 3, INTE = 4, T0IE = 5, TMR0IE = 5, PEIE = 6, GIE = 7,
+	// option_reg
+	PSA = 3, T0SE = 4, T0CS = 5, INTEDG = 6, NOT_RBPU = 7,
+	// pir1 / pie1
+	TMR1IF = 0, TMR2IF = 1, CCP1IF = 2, SSPIF = 3, TXIF = 4, RCIF = 5, ADIF = 6,
+	TMR1IE = 0, TMR2IE = 1, CCP1IE = 2, SSPIE = 3, TXIE = 4, RCIE = 5, ADIE = 6,
+	// pir2 / pie2
+	CCP2IF = 0, ULPWUIF = 2, BCLIF = 3, EEIF = 4, C1IF = 5, C2IF = 6, OSFIF = 7,
+	CCP2IE = 0, ULPWUIE = 2, BCLIE = 3, EEIE = 4, C1IE = 5, C2IE = 6, OSFIE = 7,
+	// t1con
+	TMR1ON = 0, TMR1CS = 1, NOT_T1SYNC = 2, T1OSCEN = 3, T1CKPS0 = 4, T1CKPS1 = 5, TMR1GE = 6, T1GINV = 7,
+	// eecon1
+	RD = 0, WR = 1, WREN = 2, WRERR = 3, EEPGD = 7,
+	// txsta
+	TX9D = 0, TRMT = 1, BRGH = 2, SENDB = 3, SYNC = 4, TXEN = 5, TX9 = 6, CSRC = 7,
+	// rcsta
+	RX9D = 0, OERR = 1, FERR = 2, ADDEN = 3, CREN = 4, SREN = 5, RX9 = 6, SPEN = 7,
+	// baudctl
+	ABDEN = 0, WUE = 1, BRG16 = 3, SCKP = 4, RCIDL = 6, ABDOVF = 7,
+};
+
+// The operations every register supports, so it can be used like a char.
+#define HOST_SFR_OPS(type) \
+	operator unsigned char() const  { return value; } \
+	type& operator=(unsigned char v)  { value = v; return *this; } \
+	type& operator|=(unsigned char v)  { value |= v; return *this; } \
+	type& operator&=(unsigned char v)  { value &= v; return *this; } \
+	type& operator^=(unsigned char v)  { value ^= v; return *this; }
+
+// Declares a register with the given bit names, from bit 0 up.
+#define HOST_SFR(name, b0, b1, b2, b3, b4, b5, b6, b7) \
+	union name##_t { \
+		unsigned char value; \
+		struct { unsigned char b0 : 1, b1 : 1, b2 : 1, b3 : 1, b4 : 1, b5 : 1, b6 : 1, b7 : 1; }; \
+		HOST_SFR_OPS(name##_t) \
+	}; \
+	inline name##_t name;
+
+// Same, with a second set of names for the same bits.
+#define HOST_SFR2(name, b0, b1, b2, b3, b4, b5, b6, b7, a0, a1, a2, a3, a4, a5, a6, a7) \
+	union name##_t { \
+		unsigned char value; \
+		struct { unsigned char b0 : 1, b1 : 1, b2 : 1, b3 : 1, b4 : 1, b5 : 1, b6 : 1, b7 : 1; }; \
+		struct { unsigned char a0 : 1, a1 : 1, a2 : 1, a3 : 1, a4 : 1, a5 : 1, a6 : 1, a7 : 1; }; \
+		HOST_SFR_OPS(name##_t) \
+	}; \
+	inline name##_t name;
+
+// A register whose bits are only used by number.
+#define HOST_SFR_PLAIN(name)  HOST_SFR(name, _0, _1, _2, _3, _4, _5, _6, _7)
+
+HOST_SFR2(intcon, RBIF, INTF, T0IF, RBIE, INTE, T0IE, PEIE, GIE,
+	_0, _1, TMR0IF, _3, _4, TMR0IE, _6, _7)
+HOST_SFR(option_reg, PS0, PS1, PS2, PSA, T0SE, T0CS, INTEDG, NOT_RBPU)
+HOST_SFR(pir1, TMR1IF, TMR2IF, CCP1IF, SSPIF, TXIF, RCIF, ADIF, _7)
+HOST_SFR(pie1, TMR1IE, TMR2IE, CCP1IE, SSPIE, TXIE, RCIE, ADIE, _7)
+HOST_SFR(pir2, CCP2IF, _1, ULPWUIF, BCLIF, EEIF, C1IF, C2IF, OSFIF)
+HOST_SFR(pie2, CCP2IE, _1, ULPWUIE, BCLIE, EEIE, C1IE, C2IE, OSFIE)
+HOST_SFR(t1con, TMR1ON, TMR1CS, NOT_T1SYNC, T1OSCEN, T1CKPS0, T1CKPS1, TMR1GE, T1GINV)
+HOST_SFR(eecon1, RD, WR, WREN, WRERR, _4, _5, _6, EEPGD)
+HOST_SFR(txsta, TX9D, TRMT, BRGH, SENDB, SYNC, TXEN, TX9, CSRC)
+HOST_SFR(rcsta, RX9D, OERR, FERR, ADDEN, CREN, SREN, RX9, SPEN)
+HOST_SFR(baudctl, ABDEN, WUE, _2, BRG16, SCKP, _5, RCIDL, ABDOVF)
+
+HOST_SFR_PLAIN(status)
+HOST_SFR_PLAIN(tmr0)
+HOST_SFR_PLAIN(tmr1l)
+HOST_SFR_PLAIN(tmr1h)
+HOST_SFR_PLAIN(t2con)
+HOST_SFR_PLAIN(tmr2)
+HOST_SFR_PLAIN(pr2)
+HOST_SFR_PLAIN(porta)
+HOST_SFR_PLAIN(portb)
+HOST_SFR_PLAIN(portc)
+HOST_SFR_PLAIN(porte)
+HOST_SFR_PLAIN(trisa)
+HOST_SFR_PLAIN(trisb)
+HOST_SFR_PLAIN(trisc)
+HOST_SFR_PLAIN(trise)
+HOST_SFR_PLAIN(iocb)
+HOST_SFR_PLAIN(ansel)
+HOST_SFR_PLAIN(anselh)
+HOST_SFR_PLAIN(cm1con0)
+HOST_SFR_PLAIN(cm2con0)
+HOST_SFR_PLAIN(cm2con1)
+HOST_SFR_PLAIN(srcon)
+HOST_SFR_PLAIN(vrcon)
+HOST_SFR_PLAIN(adcon0)
+HOST_SFR_PLAIN(adcon1)
+HOST_SFR_PLAIN(adresh)
+HOST_SFR_PLAIN(adresl)
+HOST_SFR_PLAIN(spbrg)
+HOST_SFR_PLAIN(spbrgh)
+HOST_SFR_PLAIN(txreg)
+HOST_SFR_PLAIN(rcreg)
+HOST_SFR_PLAIN(eeadr)
+HOST_SFR_PLAIN(eeadrh)
+HOST_SFR_PLAIN(eedata)
+HOST_SFR_PLAIN(eedath)
+HOST_SFR_PLAIN(eecon2)
+
+
+//====================================================================
+// Bit operations
+
+// The data EEPROM's contents.
+// Reads and writes through eecon1 act on this; writes finish immediately.
+inline unsigned char hostEeprom[256];
+
+template <class T>
+inline void set_bit(T& reg, unsigned char bitNum)
+{
+	reg |= (1 << bitNum);
+}
+
+inline void set_bit(eecon1_t& reg, unsigned char bitNum)
+{
+	if (bitNum == RD)
+		eedata = hostEeprom[eeadr];
+	else if (bitNum == WR) {
+		if (reg.WREN)
+			hostEeprom[eeadr] = eedata;
+		pir2.EEIF = 1;
+	} else
+		reg |= (1 << bitNum);
+}
+
+template <class T>
+inline void clear_bit(T& reg, unsigned char bitNum)
+{
+	reg &= ~(1 << bitNum);
+}
+
+template <class T>
+inline unsigned char test_bit(const T& reg, unsigned char bitNum)
+{
+	return (reg >> bitNum) & 1;
+}
+
+
+#endif
+// __HOST_SYSTEM_H
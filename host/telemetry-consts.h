@@ -0,0 +1,11 @@
+// telemetry-consts.h
+// For the host telemetry decoder (telemetryDecode.cpp), which takes the channels from the stream.
+
+#ifndef __TELEMETRY_CONSTS
+#define __TELEMETRY_CONSTS
+
+#define TELEMETRY_CHANNELS  3
+#define TELEMETRY_KEY_INTERVAL  32
+
+
+#endif
@@ -0,0 +1,189 @@
+/* telemetryDecode.cpp
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Decodes the stream from telemetry.h on a PC, and prints each frame's values
+	as a line of comma-separated numbers.
+
+	Build from the library directory, with the host system.h:
+
+		g++ -std=c++17 -O2 -funsigned-char -D_PIC16F886 -Ihost -o telemetryDecode \
+			host/telemetryDecode.cpp -x c++ crc_8bit.c
+
+	Then feed it the raw bytes from the serial port, e.g.:
+
+		stty -F /dev/ttyUSB0 9600 raw
+		./telemetryDecode < /dev/ttyUSB0
+
+	Options:
+
+		-c    frames end with a CRC (TELEMETRY_CRC)
+		-s    print the values as signed
+
+	Frames before the first keyframe, and after a lost or garbled one until the next keyframe,
+	can't be decoded; they're counted on stderr instead.
+*/
+
+#include <system.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../telemetry.h"
+#include "../crc_8bit.h"
+
+
+// Longer than any frame: a header, 3 bytes per channel, and a CRC.
+#define MAX_FRAME  256
+#define MAX_CHANNELS  MAX_FRAME
+
+static bool useCrc = false;
+static bool printSigned = false;
+
+// The last values decoded, which the next frame's changes are from.
+static unsigned short values[MAX_CHANNELS];
+static int numChannels = 0;
+
+// Set once a keyframe has been decoded, and cleared when a frame is lost.
+static bool synced = false;
+static byte lastSequence;
+
+static unsigned long decoded = 0, skipped = 0, garbled = 0;
+
+
+// Decodes a frame, once its framing has been taken off.
+static void DecodeFrame(const byte* frame, int len)
+{
+	if (useCrc) {
+		crc8Init();
+		for (int i = 0; i < len; ++i)
+			crc8(frame[i]);
+		if (len < 2 || crc != 0) {
+			++garbled;
+			synced = false;
+			return;
+		}
+		--len;
+	}
+
+	byte header = frame[0];
+	byte sequence = header & 0x7F;
+	bool key = (header & TELEMETRY_KEY) != 0;
+	if (!key && (!synced || sequence != ((lastSequence + 1) & 0x7F))) {
+		++skipped;
+		synced = false;
+		return;
+	}
+
+	// Undo the varints and zig-zag.
+	unsigned short changes[MAX_CHANNELS];
+	int count = 0;
+	unsigned long varint = 0;
+	int shift = 0;
+	for (int i = 1; i < len; ++i) {
+		// Values are 16 bits, so no more than 3 bytes each.
+		if (shift > 14) {
+			++garbled;
+			synced = false;
+			return;
+		}
+		varint |= (unsigned long) (frame[i] & 0x7F) << shift;
+		shift += 7;
+		if (!(frame[i] & 0x80)) {
+			changes[count++] = (varint >> 1) ^ -(varint & 1);
+			varint = 0;
+			shift = 0;
+		}
+	}
+	if (shift || (!key && count != numChannels)) {
+		++garbled;
+		synced = false;
+		return;
+	}
+
+	for (int i = 0; i < count; ++i)
+		values[i] = key ? changes[i] : values[i] + changes[i];
+	numChannels = count;
+	synced = true;
+	lastSequence = sequence;
+	++decoded;
+
+	for (int i = 0; i < count; ++i) {
+		if (printSigned)
+			printf(i ? ",%d" : "%d", (signed short) values[i]);
+		else
+			printf(i ? ",%u" : "%u", values[i]);
+	}
+	printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-c"))
+			useCrc = true;
+		else if (!strcmp(argv[i], "-s"))
+			printSigned = true;
+		else {
+			fprintf(stderr, "usage: telemetryDecode [-c] [-s] < stream\n");
+			return 2;
+		}
+	}
+
+	// Take off the SLIP framing.  Whatever comes before the first END may be part of a frame,
+	// so it's thrown away.
+	byte frame[MAX_FRAME];
+	int len = 0;
+	bool started = false;
+	bool escaped = false;
+	bool tooLong = false;
+	int c;
+	while ((c = getchar()) != EOF) {
+		if (c == TELEMETRY_END) {
+			if (started && len && !tooLong)
+				DecodeFrame(frame, len);
+			else if (tooLong) {
+				++garbled;
+				synced = false;
+			}
+			started = true;
+			len = 0;
+			escaped = false;
+			tooLong = false;
+			fflush(stdout);
+			continue;
+		}
+
+		if (escaped) {
+			if (c == TELEMETRY_ESC_END)
+				c = TELEMETRY_END;
+			else if (c == TELEMETRY_ESC_ESC)
+				c = TELEMETRY_ESC;
+			escaped = false;
+		} else if (c == TELEMETRY_ESC) {
+			escaped = true;
+			continue;
+		}
+
+		if (len < MAX_FRAME)
+			frame[len++] = c;
+		else
+			tooLong = true;
+	}
+
+	fprintf(stderr, "%lu frames decoded, %lu skipped, %lu garbled\n", decoded, skipped, garbled);
+	return 0;
+}
@@ -0,0 +1,11 @@
+// timerWheel-consts.h
+// For the host benchmarks (bench.cpp).
+
+
+#ifndef __TIMER_WHEEL_CONSTS
+#define __TIMER_WHEEL_CONSTS
+
+#define NUM_TIMERS  8
+
+
+#endif
@@ -0,0 +1,72 @@
+/* uiTimeDrift.cpp
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Runs an hour of uiTime's Timer 0 interrupts on a PC, and reports how far the ms count
+	ever falls behind real time, and what it comes to at the end of the hour.
+
+	UITIME_FOSC is fixed at compile time, so build and run it once per clock rate,
+	from the library directory, with the host system.h:
+
+		for f in 4000000 8000000 20000000 32000000 48000000; do
+			g++ -std=c++17 -O2 -funsigned-char -D_PIC16F886 -DUITIME_FOSC=$f -Ihost \
+				-o uiTimeDrift host/uiTimeDrift.cpp -x c++ uiTime.c && ./uiTimeDrift
+		done
+
+	Exits with 1 if the lag ever reaches 3 ms, or the hour doesn't come out as 3600 seconds
+	of uptime and 3600000 ms (less what the last interrupt's partial period hasn't made up yet).
+*/
+
+#include <system.h>
+#include <stdio.h>
+
+#include "../types-tjw.h"
+#include "../uiTime.h"
+
+
+#define HOUR_CYCLES  ((unsigned long long) UITIME_CYCLES_PER_MS * 3600000ULL)
+
+int main(void)
+{
+	InitUiTime_Timer0();
+
+	unsigned long long realCycles = 0;
+	unsigned long long msCounted = 0;
+	unsigned long long maxLagCycles = 0;
+	while (realCycles < HOUR_CYCLES) {
+		// Just before each interrupt is when the ms count is furthest behind.
+		realCycles += UITIME_CYCLES_PER_INT;
+		unsigned long long lag = realCycles - msCounted * UITIME_CYCLES_PER_MS;
+		if (lag > maxLagCycles)
+			maxLagCycles = lag;
+
+		msCounted += UiTimeAddCycles(UITIME_CYCLES_PER_INT);
+	}
+
+	// The last interrupt may have run past the hour, but by less than one period.
+	unsigned long long msDue = realCycles / UITIME_CYCLES_PER_MS;
+	double maxLagMs = (double) maxLagCycles / UITIME_CYCLES_PER_MS;
+	unsigned long seconds = GetUptime();
+
+	printf("%8lu Hz  prescale %2u  worst lag %6llu cycles (%.3f ms)  ms in an hour %llu of %llu  uptime %lu s\n",
+		(unsigned long) UITIME_FOSC, UITIME_T0_PRESCALE, maxLagCycles, maxLagMs,
+		msCounted, msDue, seconds);
+
+	if (maxLagMs >= 3 || msCounted != msDue || seconds != 3600)
+		return 1;
+	return 0;
+}
@@ -0,0 +1,24 @@
+// i2cMaster-consts.h
+// Customize this to fit your application.
+
+
+#ifndef __I2C_MASTER_CONSTS
+#define __I2C_MASTER_CONSTS
+
+// The MSSP's pins, for bus recovery.
+// These are right for the 16F88x and 18F2x20/2x50, where SCL is RC3 and SDA is RC4.
+#define I2C_PORT  portc
+#define I2C_TRIS  trisc
+#define I2C_SCL_PIN  3
+#define I2C_SDA_PIN  4
+
+// The number of transactions that can be waiting at once, including the one in progress.
+// Each one costs 2 bytes of RAM.
+#define I2C_QUEUE_LENGTH  4
+
+// Transactions with a timeout of 0 get this many ms.
+// At 100 kHz, each byte takes about 0.1 ms, so this is generous.
+#define I2C_DEFAULT_TIMEOUT_MS  20
+
+
+#endif
@@ -0,0 +1,292 @@
+/* i2cMaster.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <system.h>
+
+#define IN_I2C_MASTER
+#include "i2cMaster.h"
+
+
+#if defined(_PIC16F883) || defined(_PIC16F886)
+ #define sspcon1  sspcon
+#endif
+
+#define DIRECTION_WRITE  0
+#define DIRECTION_READ  1
+
+// SSPCON1: SSPEN, and I2C master mode with the clock from SSPADD.
+#define SSPCON1_I2C_MASTER  0x28
+
+// SSPSTAT: slew rate control off, for 100 kHz.
+#define SSPSTAT_100KHZ  0x80
+
+// The states of the transaction in progress.
+// Each names what we're waiting for the MSSP to finish.
+#define STATE_IDLE  0
+#define STATE_START  1
+#define STATE_WRITE  2  // the write address or a data byte
+#define STATE_RESTART  3
+#define STATE_READ_ADDRESS  4
+#define STATE_READ  5
+#define STATE_ACK  6
+#define STATE_STOP  7
+
+
+// Pointers to the queued transactions; the head is the one in progress.
+static I2CTransaction* i2cQueue[I2C_QUEUE_LENGTH];
+static byte i2cHead;
+static byte i2cCount;
+
+static byte i2cState;
+static byte i2cIndex;  // into the current buffer
+static byte i2cResult;  // saved while the stop goes out
+static byte i2cBusyMs;
+static byte i2cTimeoutMs;
+
+
+// Sets up the MSSP as an I2C master, using the baud rate already in SSPADD.
+static void EnableMSSP(void)
+{
+	sspstat = SSPSTAT_100KHZ;
+	sspcon2 = 0;
+	sspcon1 = SSPCON1_I2C_MASTER;
+}
+
+// Starts the transaction at the head of the queue, if there is one.
+static void StartNext(void)
+{
+	if (!i2cCount) {
+		i2cState = STATE_IDLE;
+		return;
+	}
+
+	I2CTransaction* t = i2cQueue[i2cHead];
+	i2cTimeoutMs = t->timeoutMs? t->timeoutMs: I2C_DEFAULT_TIMEOUT_MS;
+	i2cBusyMs = 0;
+	i2cIndex = 0;
+
+	i2cState = STATE_START;
+	sspcon2.SEN = 1;
+}
+
+// Reports the result of the transaction in progress, and goes on to the next.
+static void FinishTransaction(byte result)
+{
+	i2cQueue[i2cHead]->status = result;
+	if (++i2cHead >= I2C_QUEUE_LENGTH)
+		i2cHead = 0;
+	--i2cCount;
+
+	StartNext();
+}
+
+// Ends the transaction in progress with a stop condition.
+// It's reported once the stop has gone out.
+static void SendStop(byte result)
+{
+	i2cResult = result;
+	i2cState = STATE_STOP;
+	sspcon2.PEN = 1;
+}
+
+void InitI2CMaster(byte baud)
+{
+	i2cHead = 0;
+	i2cCount = 0;
+	i2cState = STATE_IDLE;
+
+	I2C_TRIS.I2C_SCL_PIN = 1;
+	I2C_TRIS.I2C_SDA_PIN = 1;
+	sspadd = baud;
+	I2CBusRecover();
+
+	pir1.SSPIF = 0;
+	pir2.BCLIF = 0;
+	pie1.SSPIE = 1;
+	pie2.BCLIE = 1;
+	intcon.PEIE = 1;
+}
+
+void I2CMasterInterrupt(void)
+{
+	if (pir2.BCLIF) {
+		// The MSSP has already given up the bus and gone idle.
+		pir2.BCLIF = 0;
+		pir1.SSPIF = 0;
+		if (i2cState != STATE_IDLE)
+			FinishTransaction(I2C_COLLISION);
+		return;
+	}
+
+	if (!pir1.SSPIF)
+		return;
+	pir1.SSPIF = 0;
+
+	I2CTransaction* t = i2cQueue[i2cHead];
+
+	switch (i2cState) {
+	case STATE_START:
+		if (!t->writeLen && t->readLen) {
+			i2cState = STATE_READ_ADDRESS;
+			sspbuf = t->address | DIRECTION_READ;
+		} else {
+			// A transaction with nothing to read or write just probes the address.
+			i2cState = STATE_WRITE;
+			sspbuf = t->address | DIRECTION_WRITE;
+		}
+		break;
+
+	case STATE_WRITE:
+		if (sspcon2.ACKSTAT)
+			SendStop(I2C_NACK);
+		else if (i2cIndex < t->writeLen)
+			sspbuf = t->writeBuf[i2cIndex++];
+		else if (t->readLen) {
+			i2cState = STATE_RESTART;
+			sspcon2.RSEN = 1;
+		} else
+			SendStop(I2C_DONE);
+		break;
+
+	case STATE_RESTART:
+		i2cState = STATE_READ_ADDRESS;
+		sspbuf = t->address | DIRECTION_READ;
+		break;
+
+	case STATE_READ_ADDRESS:
+		if (sspcon2.ACKSTAT)
+			SendStop(I2C_NACK);
+		else {
+			i2cIndex = 0;
+			i2cState = STATE_READ;
+			sspcon2.RCEN = 1;
+		}
+		break;
+
+	case STATE_READ:
+		t->readBuf[i2cIndex++] = sspbuf;
+
+		// NACK the last byte, so the slave lets go of SDA for the stop.
+		sspcon2.ACKDT = i2cIndex >= t->readLen;
+		i2cState = STATE_ACK;
+		sspcon2.ACKEN = 1;
+		break;
+
+	case STATE_ACK:
+		if (i2cIndex < t->readLen) {
+			i2cState = STATE_READ;
+			sspcon2.RCEN = 1;
+		} else
+			SendStop(I2C_DONE);
+		break;
+
+	case STATE_STOP:
+		FinishTransaction(i2cResult);
+		break;
+	}
+}
+
+void I2CMasterTickMs(void)
+{
+	if (i2cState == STATE_IDLE)
+		return;
+
+	if (++i2cBusyMs < i2cTimeoutMs)
+		return;
+
+	// Take the MSSP out of whatever it was doing, and free the bus by hand.
+	sspcon1.SSPEN = 0;
+	pir1.SSPIF = 0;
+	I2CBusRecover();
+	FinishTransaction(I2C_TIMEOUT);
+}
+
+byte I2CSubmit(I2CTransaction* t)
+{
+	byte result = false;
+
+	intcon.GIE = 0;
+
+	if (i2cCount < I2C_QUEUE_LENGTH) {
+		t->status = I2C_PENDING;
+
+		byte i = i2cHead + i2cCount;
+		if (i >= I2C_QUEUE_LENGTH)
+			i -= I2C_QUEUE_LENGTH;
+		i2cQueue[i] = t;
+		++i2cCount;
+
+		if (i2cState == STATE_IDLE)
+			StartNext();
+		result = true;
+	} else
+		t->status = I2C_QUEUE_FULL;
+
+	intcon.GIE = 1;
+
+	return result;
+}
+
+byte I2CWait(I2CTransaction* t)
+{
+	while (t->status == I2C_PENDING)
+		;
+	return t->status;
+}
+
+byte I2CIsIdle(void)
+{
+	return i2cState == STATE_IDLE;
+}
+
+// Pull a pin low, or let it float high, as open-drain.
+// The port bit is cleared each time before it's driven, since a read-modify-write of the port
+// elsewhere while the pin floated high would have latched a 1, and driven the bus high.
+#define I2C_PULL_LOW(pin)  { I2C_PORT.pin = 0; I2C_TRIS.pin = 0; }
+#define I2C_RELEASE(pin)  { I2C_TRIS.pin = 1; }
+
+byte I2CBusRecover(void)
+{
+	sspcon1.SSPEN = 0;
+
+	I2C_RELEASE(I2C_SCL_PIN);
+	I2C_RELEASE(I2C_SDA_PIN);
+
+	// A slave in the middle of sending a byte lets go of SDA within 9 clocks.
+	byte i;
+	for (i = 0; i < 9 && !I2C_PORT.I2C_SDA_PIN; ++i) {
+		I2C_PULL_LOW(I2C_SCL_PIN);
+		delay_us(5);
+		I2C_RELEASE(I2C_SCL_PIN);
+		delay_us(5);
+	}
+
+	// Send a stop: SDA rises while SCL is high.
+	I2C_PULL_LOW(I2C_SCL_PIN);
+	I2C_PULL_LOW(I2C_SDA_PIN);
+	delay_us(5);
+	I2C_RELEASE(I2C_SCL_PIN);
+	delay_us(5);
+	I2C_RELEASE(I2C_SDA_PIN);
+	delay_us(5);
+
+	byte result = I2C_PORT.I2C_SDA_PIN && I2C_PORT.I2C_SCL_PIN;
+
+	EnableMSSP();
+
+	return result;
+}
@@ -0,0 +1,143 @@
+/* i2cMaster.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Interrupt-driven I2C master, using the MSSP.
+
+	Callers fill in an I2CTransaction - a write, a read, or a write followed by
+	a repeated start and a read - and submit it.  Transactions are queued and run
+	one after another from the MSSP interrupt, so the main loop is free while the
+	bytes go out.  Check the transaction's status to see when it's finished.
+
+	Every transaction that gets as far as a start condition ends with a stop,
+	whether it succeeds or the slave NACKs.  A transaction that takes longer than
+	its timeout is abandoned, and the bus is recovered by clocking SCL until the
+	slave lets go of SDA.
+
+	Don't use this along with the blocking i2c_driver calls; it owns the MSSP.
+
+	Sample code:
+
+		byte rtcRegister = 0;
+		byte rtcBuf[7];
+		I2CTransaction rtcRead;
+
+		void interrupt(void)
+		{
+			I2CMasterInterrupt();
+
+			byte ms = UiTimeInterrupt();
+			while (ms--)
+				I2CMasterTickMs();
+		}
+
+		...
+		InitI2CMaster(0x12);
+
+		rtcRead.address = 0xD0;
+		rtcRead.writeBuf = &rtcRegister;
+		rtcRead.writeLen = 1;
+		rtcRead.readBuf = rtcBuf;
+		rtcRead.readLen = 7;
+		rtcRead.timeoutMs = 0;
+		I2CSubmit(&rtcRead);
+
+		while (1) {
+			if (rtcRead.status == I2C_DONE) {
+				...
+			}
+			...
+		}
+
+	Or, from a task:
+
+		TASK_WAIT_UNTIL(t, I2CIsFinished(&rtcRead));
+
+	Requires i2cMaster-consts.h, customized from i2cMaster-consts-template.h.
+*/
+
+#ifndef __I2C_MASTER_H
+#define __I2C_MASTER_H
+
+#ifdef IN_I2C_MASTER
+ #define I2C_MASTER_EXTERN
+#else
+ #define I2C_MASTER_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+#include "i2cMaster-consts.h"
+
+
+// Values for I2CTransaction.status.
+#define I2C_PENDING  0  // queued or in progress
+#define I2C_DONE  1  // finished successfully
+#define I2C_NACK  2  // the slave didn't acknowledge its address or a byte we wrote
+#define I2C_TIMEOUT  3  // took too long; the bus was recovered
+#define I2C_COLLISION  4  // another master, or noise, took the bus
+#define I2C_QUEUE_FULL  5  // I2CSubmit() couldn't queue it
+
+
+typedef struct {
+	byte address;  // the slave's 8-bit write address, e.g. 0xD0 for the DS1307
+	byte* writeBuf;  // written first, if writeLen is nonzero
+	byte writeLen;
+	byte* readBuf;  // then read, if readLen is nonzero
+	byte readLen;
+	byte timeoutMs;  // 0 for I2C_DEFAULT_TIMEOUT_MS
+	volatile byte status;  // set by this module
+} I2CTransaction;
+
+
+// Call this once to initialize, before enabling interrupts.
+// baud goes into SSPADD; see the "I2C clock rate w/BRG" table in the data sheet.
+// Also recovers the bus, in case a slave was left holding it by a reset.
+void InitI2CMaster(byte baud);
+
+// Call this from the ISR.  Handles the MSSP and bus collision interrupts.
+void I2CMasterInterrupt(void);
+
+// Call this from the ISR once per ms, e.g. for each ms from UiTimeInterrupt().
+// Enforces the timeout on the transaction in progress.
+void I2CMasterTickMs(void);
+
+// Queues the given transaction, and starts it if the bus is idle.
+// The transaction, and its buffers, must stay put until it's finished.
+// Returns false, without queuing it, if the queue is full; its status is then I2C_QUEUE_FULL.
+byte I2CSubmit(I2CTransaction* t);
+
+// Returns true once the given transaction has finished, successfully or not.
+inline byte I2CIsFinished(I2CTransaction* t)
+{
+	return t->status != I2C_PENDING;
+}
+
+// Waits for the given transaction to finish, and returns its status.
+byte I2CWait(I2CTransaction* t);
+
+// Returns true if no transactions are queued or in progress.
+byte I2CIsIdle(void);
+
+// Frees the bus, if a slave is holding SDA low, by clocking SCL up to 9 times
+// and then sending a stop.  Returns true if the bus is free afterward.
+// Called automatically on a timeout; only call it yourself when idle.
+byte I2CBusRecover(void);
+
+
+#endif
@@ -25,11 +25,12 @@
 */
 
 #include <system.h>
+#include "types-tjw.h"
 #include "fixed16.h"
 
 #include "log.h"
 
-rom unsigned char* log_table = {
+ROM_TABLE(unsigned char, log_table) = {
 	0x00,  // 0x100*log2(0x100/0x100)
 	0x16,  // 0x100*log2(0x110/0x100)
 	0x2b,  // 0x100*log2(0x120/0x100)
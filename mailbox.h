@@ -0,0 +1,87 @@
+/* mailbox.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	A one-value mailbox, for handing the latest reading from an ISR to the main loop.
+
+	The ISR posts whenever it has a new value; the main loop takes the newest one
+	whenever it gets around to it, and any it missed in between are simply replaced.
+	Values can be any size, and are never torn, without disabling interrupts:
+	there are two buffers, and the ISR always writes the one the main loop isn't reading.
+	(That's enough because the main loop can't interrupt the ISR.)
+
+	Any number of mailboxes can be declared, of any types:
+
+		MAILBOX(TempReading) tempBox;
+
+		void interrupt(void)
+		{
+			...
+			TempReading* r = MailboxPostSlot(tempBox);
+			r->celsius = ...;
+			r->ticks = ticks;
+			MailboxPost(tempBox);
+		}
+
+		...
+		if (MailboxHasNew(tempBox)) {
+			TempReading* r = MailboxTake(tempBox);
+			ShowTemp(r->celsius);
+		}
+
+	The value from MailboxTake() stays put until the next MailboxTake().
+	A mailbox starts out empty if it's a global (all zeroes), or after MailboxClear().
+*/
+
+#ifndef __MAILBOX_H
+#define __MAILBOX_H
+
+#include "types-tjw.h"
+
+
+// Declares a mailbox holding values of the given type.
+#define MAILBOX(type)  struct { \
+	type buf[2]; \
+	volatile byte latest;  /* the buffer posted last */ \
+	volatile byte reading;  /* the buffer the main loop is using; the ISR writes the other one */ \
+	volatile byte fresh;  /* set when latest hasn't been taken yet */ \
+}
+
+// Empties the mailbox.
+#define MailboxClear(mb)  { (mb).fresh = 0; (mb).reading = 0; (mb).latest = 0; }
+
+
+// ISR side:  fill in the value at MailboxPostSlot(), then call MailboxPost().
+
+// Returns a pointer to the buffer for the next value.
+#define MailboxPostSlot(mb)  (&(mb).buf[(mb).reading ^ 1])
+
+// Makes the value at MailboxPostSlot() the newest one.
+#define MailboxPost(mb)  { (mb).latest = (mb).reading ^ 1; (mb).fresh = 1; }
+
+
+// Main loop side.
+
+// True if a value has been posted since the last MailboxTake().
+#define MailboxHasNew(mb)  ((mb).fresh)
+
+// Returns a pointer to the newest value, and marks it as taken.
+// The flag's cleared first, so a value posted meanwhile is seen next time rather than lost.
+#define MailboxTake(mb)  ((mb).fresh = 0, (mb).reading = (mb).latest, &(mb).buf[(mb).reading])
+
+
+#endif
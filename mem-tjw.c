@@ -15,17 +15,278 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-void copyBytes(char* dst, char* src, unsigned char len)
+#include <system.h>
+
+#include "types-tjw.h"
+#include "mem-tjw.h"
+
+
+#if defined(_PIC18F2620) || defined(_PIC18F2320) || defined(_PIC18F1320) || defined(_PIC18F2550)
+ #define MEM_PIC18
+#endif
+
+
+#ifdef MEM_PIC18
+
+// These count the low byte of len down to 0 in the inner loop,
+// then borrow 256 at a time from the high byte.
+// FSR0 and FSR1 are only used within each asm block, so they needn't be saved.
+
+void copyBytes(char* dst, char* src, unsigned short len)
 {
-	while (len--)
+	asm {
+		movff	_src, _fsr0l
+		movff	_src+1, _fsr0h
+		movff	_dst, _fsr1l
+		movff	_dst+1, _fsr1h
+		movf	_len, F
+		bz		copy_borrow
+	copy_loop:
+		movff	_postinc0, _postinc1
+		decfsz	_len, F
+		bra		copy_loop
+	copy_borrow:
+		movf	_len+1, F
+		bz		copy_done
+		decf	_len+1, F
+		bra		copy_loop
+	copy_done:
+	}
+}
+
+void fillBytes(char* dst, char value, unsigned short len)
+{
+	asm {
+		movff	_dst, _fsr1l
+		movff	_dst+1, _fsr1h
+		movf	_value, W
+		movf	_len, F
+		bz		fill_borrow
+	fill_loop:
+		movwf	_postinc1
+		decfsz	_len, F
+		bra		fill_loop
+	fill_borrow:
+		movf	_len+1, F
+		bz		fill_done
+		decf	_len+1, F
+		bra		fill_loop
+	fill_done:
+	}
+}
+
+unsigned char bytesEqual(char* a, char* b, unsigned short len)
+{
+	unsigned char result = 1;
+	
+	asm {
+		movff	_a, _fsr0l
+		movff	_a+1, _fsr0h
+		movff	_b, _fsr1l
+		movff	_b+1, _fsr1h
+		movf	_len, F
+		bz		equal_borrow
+	equal_loop:
+		movf	_postinc0, W
+		cpfseq	_postinc1
+		bra		equal_differ
+		decfsz	_len, F
+		bra		equal_loop
+	equal_borrow:
+		movf	_len+1, F
+		bz		equal_done
+		decf	_len+1, F
+		bra		equal_loop
+	equal_differ:
+		clrf	_result
+	equal_done:
+	}
+	
+	return result;
+}
+
+#else
+
+// The leftover 0-3 bytes go first, so the main loop only has to test len every 4 bytes.
+
+void copyBytes(char* dst, char* src, unsigned short len)
+{
+	byte odd = len & 3;
+	while (odd--)
+		*dst++ = *src++;
+	
+	len >>= 2;
+	while (len--) {
+		*dst++ = *src++;
+		*dst++ = *src++;
 		*dst++ = *src++;
+		*dst++ = *src++;
+	}
+}
+
+void fillBytes(char* dst, char value, unsigned short len)
+{
+	byte odd = len & 3;
+	while (odd--)
+		*dst++ = value;
+	
+	len >>= 2;
+	while (len--) {
+		*dst++ = value;
+		*dst++ = value;
+		*dst++ = value;
+		*dst++ = value;
+	}
 }
 
-unsigned char bytesEqual(char* a, char* b, unsigned char len)
+unsigned char bytesEqual(char* a, char* b, unsigned short len)
 {
-	while (len--)
+	byte odd = len & 3;
+	while (odd--)
+		if (*a++ != *b++)
+			return 0;
+	
+	len >>= 2;
+	while (len--) {
 		if (*a++ != *b++)
 			return 0;
-			
+		if (*a++ != *b++)
+			return 0;
+		if (*a++ != *b++)
+			return 0;
+		if (*a++ != *b++)
+			return 0;
+	}
+	
 	return 1;
 }
+
+#endif
+
+// rom pointers are opaque to asm - BoostC reaches the table through its own access code -
+// so this is plain C on both families, indexed by a byte where it can be.
+void copyRomBytes(char* dst, rom char* src, unsigned short len)
+{
+	while (len >= 256) {
+		byte i = 0;
+		do {
+			*dst++ = src[i];
+		} while (++i);
+		src += 256;
+		len -= 256;
+	}
+	
+	byte i;
+	for (i = 0; i < (byte) len; ++i)
+		*dst++ = src[i];
+}
+
+
+#ifdef TEST_MEM_TJW
+// Run this in the simulator, on each chip family of interest.
+// Times each routine on BENCH_LEN bytes with Timer 1 at 1:1, so the results are instruction cycles;
+// watch the *Cycles variables at the end.
+#include <memory.h>
+
+#define BENCH_LEN  64
+
+char benchA[BENCH_LEN];
+char benchB[BENCH_LEN];
+rom char* benchRom = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+	32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+	48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63
+};
+
+// This module's routines.
+unsigned short copyCycles, fillCycles, equalCycles, romCycles;
+
+// The original byte loops.
+unsigned short loopCopyCycles, loopEqualCycles, loopRomCycles;
+
+// The compiler's library.
+unsigned short memcpyCycles, memsetCycles, memcmpCycles;
+
+byte benchOK;  // should end up 1
+
+inline void StartBench(void)
+{
+	tmr1h = 0;
+	tmr1l = 0;
+}
+
+inline unsigned short EndBench(void)
+{
+	unsigned short result;
+	MAKESHORT(result, tmr1l, tmr1h);
+	return result;
+}
+
+void main(void)
+{
+	t1con = 0x01;  // 1:1 on the instruction clock
+	benchOK = 1;
+	
+	StartBench();
+	fillBytes(benchA, 0x55, BENCH_LEN);
+	fillCycles = EndBench();
+	
+	StartBench();
+	memset(benchB, 0x55, BENCH_LEN);
+	memsetCycles = EndBench();
+	
+	StartBench();
+	benchOK &= bytesEqual(benchA, benchB, BENCH_LEN);
+	equalCycles = EndBench();
+	
+	StartBench();
+	benchOK &= memcmp(benchA, benchB, BENCH_LEN) == 0;
+	memcmpCycles = EndBench();
+	
+	StartBench();
+	{
+		char* a = benchA;
+		char* b = benchB;
+		byte len = BENCH_LEN;
+		while (len--)
+			if (*a++ != *b++)
+				break;
+	}
+	loopEqualCycles = EndBench();
+	
+	StartBench();
+	copyRomBytes(benchA, benchRom, BENCH_LEN);
+	romCycles = EndBench();
+	
+	StartBench();
+	{
+		byte i;
+		for (i = 0; i < BENCH_LEN; ++i)
+			benchB[i] = benchRom[i];
+	}
+	loopRomCycles = EndBench();
+	benchOK &= bytesEqual(benchA, benchB, BENCH_LEN);
+	
+	StartBench();
+	copyBytes(benchB, benchA, BENCH_LEN);
+	copyCycles = EndBench();
+	
+	StartBench();
+	memcpy(benchB, benchA, BENCH_LEN);
+	memcpyCycles = EndBench();
+	
+	StartBench();
+	{
+		char* dst = benchB;
+		char* src = benchA;
+		byte len = BENCH_LEN;
+		while (len--)
+			*dst++ = *src++;
+	}
+	loopCopyCycles = EndBench();
+	
+	benchOK &= benchB[BENCH_LEN - 1] == BENCH_LEN - 1;
+	benchOK &= !bytesEqual(benchA, benchB + 1, BENCH_LEN - 1);
+}
+#endif
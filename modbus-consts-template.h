@@ -0,0 +1,26 @@
+// modbus-consts.h
+// Customize this to fit your application.
+
+
+#ifndef __MODBUS_CONSTS
+#define __MODBUS_CONSTS
+
+// The bit rate.  The baud rate generator is set from this and UITIME_FOSC;
+// it has to come within 2% of this, or modbus.c won't compile.
+#define MODBUS_BAUD  19200
+
+// The longest frame that can be received or sent, including the address and CRC.
+// Requests for more registers than fit in a response are answered with an exception;
+// each register takes 2 bytes, plus 5 for the rest of the frame.  Max 255.
+#define MODBUS_BUFFER_LENGTH  40
+
+// The holding registers (read/write) start at this register address.
+#define MODBUS_HOLDING_START  0
+#define MODBUS_HOLDING_COUNT  8
+
+// The input registers (read-only) start at this register address.
+#define MODBUS_INPUT_START  0
+#define MODBUS_INPUT_COUNT  8
+
+
+#endif
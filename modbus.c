@@ -0,0 +1,371 @@
+/* modbus.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_MODBUS
+
+#include <system.h>
+
+#include "modbus.h"
+#include "power.h"
+#include "uiTime.h"
+
+
+// The EUSART's baud rate control register, on chips that have one (as in serial.h).
+// With it, the baud rate generator is 16 bits, and divides by 4 rather than 16.
+#if defined(_PIC16F688) || defined(_PIC16F690) || defined(_PIC16F883) || defined(_PIC16F886) || defined(_PIC18F1320)
+ #define MODBUS_BAUDCTL  baudctl
+#elif defined(_PIC18F2550) || defined(_PIC18F2620)
+ #define MODBUS_BAUDCTL  baudcon
+#endif
+
+// The baud rate generator setting, with BRGH, rounded to the nearest.
+#ifdef MODBUS_BAUDCTL
+ #define MODBUS_BRG_DIVIDE  4
+ #define MODBUS_BRG_MAX  65535
+#else
+ #define MODBUS_BRG_DIVIDE  16
+ #define MODBUS_BRG_MAX  255
+#endif
+#define MODBUS_SPBRG  ((UITIME_FOSC / MODBUS_BRG_DIVIDE + MODBUS_BAUD / 2) / MODBUS_BAUD - 1)
+#if MODBUS_SPBRG > MODBUS_BRG_MAX || MODBUS_SPBRG < 1
+ #error "modbus.c - MODBUS_BAUD is out of range for this oscillator"
+#endif
+
+// The rate that gives, which has to be within 2% of MODBUS_BAUD to talk reliably.
+#define MODBUS_ACTUAL_BAUD  (UITIME_FOSC / MODBUS_BRG_DIVIDE / (MODBUS_SPBRG + 1))
+#if MODBUS_ACTUAL_BAUD * 50 > MODBUS_BAUD * 51 || MODBUS_ACTUAL_BAUD * 50 < MODBUS_BAUD * 49
+ #error "modbus.c - MODBUS_BAUD can't be made within 2% from this oscillator"
+#endif
+
+// The quiet time that ends a frame, in ms: 3.5 characters of 11 bits,
+// or 1.75 ms above 19200 baud as the spec allows, rounded up.
+// One more, since the first tick after a byte can come at any time.
+#if MODBUS_BAUD > 19200
+ #define MODBUS_GAP_MS  3
+#else
+ #define MODBUS_GAP_MS  ((38500 + MODBUS_BAUD - 1) / MODBUS_BAUD + 1)
+#endif
+
+// Values for mbState.
+#define MB_RECEIVING  0  // collecting a frame, if any bytes have come in
+#define MB_FRAME  1  // a frame is complete, and waiting for UpdateModbus()
+#define MB_SENDING  2  // the response is going out
+
+// The request, and then the response, in place.
+static byte mbBuffer[MODBUS_BUFFER_LENGTH];
+static byte mbLen;  // bytes received, or to send
+static byte mbTxIndex;  // next byte to send
+static byte mbOverflow;  // the frame didn't fit
+static byte mbSilentMs;
+static byte mbState;
+
+
+// The CRC table, split into low and high bytes.
+// Entry i is the CRC of the single byte i, starting from 0.
+ROM_TABLE(char, crcLoTable) = {
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x00, 0xc1, 0x81, 0x40, 0x01, 0xc0, 0x80, 0x41, 
+	0x01, 0xc0, 0x80, 0x41, 0x00, 0xc1, 0x81, 0x40, 
+};
+
+ROM_TABLE(char, crcHiTable) = {
+	0x00, 0xc0, 0xc1, 0x01, 0xc3, 0x03, 0x02, 0xc2, 
+	0xc6, 0x06, 0x07, 0xc7, 0x05, 0xc5, 0xc4, 0x04, 
+	0xcc, 0x0c, 0x0d, 0xcd, 0x0f, 0xcf, 0xce, 0x0e, 
+	0x0a, 0xca, 0xcb, 0x0b, 0xc9, 0x09, 0x08, 0xc8, 
+	0xd8, 0x18, 0x19, 0xd9, 0x1b, 0xdb, 0xda, 0x1a, 
+	0x1e, 0xde, 0xdf, 0x1f, 0xdd, 0x1d, 0x1c, 0xdc, 
+	0x14, 0xd4, 0xd5, 0x15, 0xd7, 0x17, 0x16, 0xd6, 
+	0xd2, 0x12, 0x13, 0xd3, 0x11, 0xd1, 0xd0, 0x10, 
+	0xf0, 0x30, 0x31, 0xf1, 0x33, 0xf3, 0xf2, 0x32, 
+	0x36, 0xf6, 0xf7, 0x37, 0xf5, 0x35, 0x34, 0xf4, 
+	0x3c, 0xfc, 0xfd, 0x3d, 0xff, 0x3f, 0x3e, 0xfe, 
+	0xfa, 0x3a, 0x3b, 0xfb, 0x39, 0xf9, 0xf8, 0x38, 
+	0x28, 0xe8, 0xe9, 0x29, 0xeb, 0x2b, 0x2a, 0xea, 
+	0xee, 0x2e, 0x2f, 0xef, 0x2d, 0xed, 0xec, 0x2c, 
+	0xe4, 0x24, 0x25, 0xe5, 0x27, 0xe7, 0xe6, 0x26, 
+	0x22, 0xe2, 0xe3, 0x23, 0xe1, 0x21, 0x20, 0xe0, 
+	0xa0, 0x60, 0x61, 0xa1, 0x63, 0xa3, 0xa2, 0x62, 
+	0x66, 0xa6, 0xa7, 0x67, 0xa5, 0x65, 0x64, 0xa4, 
+	0x6c, 0xac, 0xad, 0x6d, 0xaf, 0x6f, 0x6e, 0xae, 
+	0xaa, 0x6a, 0x6b, 0xab, 0x69, 0xa9, 0xa8, 0x68, 
+	0x78, 0xb8, 0xb9, 0x79, 0xbb, 0x7b, 0x7a, 0xba, 
+	0xbe, 0x7e, 0x7f, 0xbf, 0x7d, 0xbd, 0xbc, 0x7c, 
+	0xb4, 0x74, 0x75, 0xb5, 0x77, 0xb7, 0xb6, 0x76, 
+	0x72, 0xb2, 0xb3, 0x73, 0xb1, 0x71, 0x70, 0xb0, 
+	0x50, 0x90, 0x91, 0x51, 0x93, 0x53, 0x52, 0x92, 
+	0x96, 0x56, 0x57, 0x97, 0x55, 0x95, 0x94, 0x54, 
+	0x9c, 0x5c, 0x5d, 0x9d, 0x5f, 0x9f, 0x9e, 0x5e, 
+	0x5a, 0x9a, 0x9b, 0x5b, 0x99, 0x59, 0x58, 0x98, 
+	0x88, 0x48, 0x49, 0x89, 0x4b, 0x8b, 0x8a, 0x4a, 
+	0x4e, 0x8e, 0x8f, 0x4f, 0x8d, 0x4d, 0x4c, 0x8c, 
+	0x44, 0x84, 0x85, 0x45, 0x87, 0x47, 0x46, 0x86, 
+	0x82, 0x42, 0x43, 0x83, 0x41, 0x81, 0x80, 0x40, 
+};
+
+unsigned short ModbusCrc(byte* buf, byte len)
+{
+	byte lo = 0xFF;
+	byte hi = 0xFF;
+	while (len--) {
+		byte i = lo ^ *buf++;
+		lo = hi ^ crcLoTable[i];
+		hi = crcHiTable[i];
+	}
+
+	unsigned short result;
+	MAKESHORT(result, lo, hi);
+	return result;
+}
+
+// Puts the CRC of the first len bytes of the buffer after them, and starts sending.
+static void SendResponse(byte len)
+{
+	unsigned short crc = ModbusCrc(mbBuffer, len);
+	LOBYTE(mbBuffer[len], crc);
+	HIBYTE(mbBuffer[len + 1], crc);
+
+	mbLen = len + 2;
+	mbTxIndex = 0;
+	mbState = MB_SENDING;
+	pie1.TXIE = 1;
+}
+
+// Turns the request into an exception response with the given code.
+// Returns its length, before the CRC.
+static byte Exception(byte code)
+{
+	mbBuffer[1] |= 0x80;
+	mbBuffer[2] = code;
+	return 3;
+}
+
+// Checks that count registers starting at address first (relative to the start of the array)
+// fall within an array of the given size.
+inline byte InRange(unsigned short first, unsigned short count, unsigned short size)
+{
+	return first < size && count <= size - first;
+}
+
+// Handles the request in the buffer, and leaves the response there.
+// Returns the length of the response, before the CRC.
+static byte HandleRequest(void)
+{
+	byte function = mbBuffer[1];
+	unsigned short address;
+	unsigned short count;
+	unsigned short* regs;
+	byte i;
+
+	MAKESHORT(address, mbBuffer[3], mbBuffer[2]);
+	MAKESHORT(count, mbBuffer[5], mbBuffer[4]);
+
+	switch (function) {
+	case 3:
+	case 4:
+		if (mbLen != 8)
+			return Exception(MODBUS_ILLEGAL_VALUE);
+		if (count == 0 || count > (MODBUS_BUFFER_LENGTH - 5) / 2)
+			return Exception(MODBUS_ILLEGAL_VALUE);
+
+		if (function == 3) {
+			address -= MODBUS_HOLDING_START;
+			if (!InRange(address, count, MODBUS_HOLDING_COUNT))
+				return Exception(MODBUS_ILLEGAL_ADDRESS);
+			regs = &modbusHolding[address];
+		} else {
+			address -= MODBUS_INPUT_START;
+			if (!InRange(address, count, MODBUS_INPUT_COUNT))
+				return Exception(MODBUS_ILLEGAL_ADDRESS);
+			regs = &modbusInput[address];
+		}
+
+		// Address, function, byte count, then the registers, high byte first.
+		mbBuffer[2] = count << 1;
+		for (i = 0; i < count; ++i) {
+			HIBYTE(mbBuffer[3 + (i << 1)], regs[i]);
+			LOBYTE(mbBuffer[4 + (i << 1)], regs[i]);
+		}
+		return 3 + (count << 1);
+
+	case 6:
+		if (mbLen != 8)
+			return Exception(MODBUS_ILLEGAL_VALUE);
+		address -= MODBUS_HOLDING_START;
+		if (!InRange(address, 1, MODBUS_HOLDING_COUNT))
+			return Exception(MODBUS_ILLEGAL_ADDRESS);
+
+		// count is really the value.
+		modbusHolding[address] = count;
+		modbusHoldingWritten = true;
+
+		// The response echoes the request.
+		return 6;
+
+	case 16:
+		if (count == 0 || count > (MODBUS_BUFFER_LENGTH - 9) / 2
+			|| mbBuffer[6] != count << 1 || mbLen != 9 + (count << 1)
+		)
+			return Exception(MODBUS_ILLEGAL_VALUE);
+		address -= MODBUS_HOLDING_START;
+		if (!InRange(address, count, MODBUS_HOLDING_COUNT))
+			return Exception(MODBUS_ILLEGAL_ADDRESS);
+
+		regs = &modbusHolding[address];
+		for (i = 0; i < count; ++i)
+			MAKESHORT(regs[i], mbBuffer[8 + (i << 1)], mbBuffer[7 + (i << 1)]);
+		modbusHoldingWritten = true;
+
+		// Address, function, starting address, and count, as in the request.
+		return 6;
+
+	default:
+		return Exception(MODBUS_ILLEGAL_FUNCTION);
+	}
+}
+
+// Starts listening for the next frame.
+inline void StartReceiving(void)
+{
+	mbLen = 0;
+	mbOverflow = false;
+	mbSilentMs = 0;
+	mbState = MB_RECEIVING;
+}
+
+void InitModbus(byte address)
+{
+	modbusAddress = address;
+	modbusHoldingWritten = false;
+	modbusErrors = 0;
+	StartReceiving();
+
+	txsta.BRGH = 1;
+	#ifdef MODBUS_BAUDCTL
+		MODBUS_BAUDCTL.BRG16 = 1;
+		spbrgh = MODBUS_SPBRG >> 8;
+	#endif
+	spbrg = MODBUS_SPBRG & 0xFF;
+	txsta.SYNC = 0;
+	rcsta.SPEN = 1;
+	txsta.TXEN = 1;
+	rcsta.CREN = 1;
+
+	pie1.TXIE = 0;
+	pie1.RCIE = 1;
+	intcon.PEIE = 1;
+
+	// Reception needs the clock, so we can't sleep through it.
+	PowerNeedClock(POWER_SERIAL);
+}
+
+void ModbusInterrupt(void)
+{
+	if (pir1.RCIF) {
+		if (rcsta.OERR) {
+			// Bytes were lost; the only way to clear it is to restart the receiver.
+			rcsta.CREN = 0;
+			rcsta.CREN = 1;
+			mbOverflow = true;
+		} else {
+			// Reading it clears the interrupt, and any framing error.
+			byte framingError = rcsta.FERR;
+			byte b = rcreg;
+
+			if (mbState == MB_RECEIVING) {
+				if (framingError || mbLen == MODBUS_BUFFER_LENGTH)
+					mbOverflow = true;
+				else
+					mbBuffer[mbLen++] = b;
+			}
+		}
+
+		mbSilentMs = 0;
+	}
+
+	if (pie1.TXIE && pir1.TXIF) {
+		txreg = mbBuffer[mbTxIndex];
+		if (++mbTxIndex == mbLen) {
+			pie1.TXIE = 0;
+			StartReceiving();
+		}
+	}
+}
+
+void ModbusTickMs(void)
+{
+	if (mbState == MB_RECEIVING && (mbLen || mbOverflow)) {
+		if (++mbSilentMs >= MODBUS_GAP_MS)
+			mbState = MB_FRAME;
+	}
+}
+
+void UpdateModbus(void)
+{
+	if (mbState != MB_FRAME)
+		return;
+
+	if (mbOverflow || mbLen < 4 || ModbusCrc(mbBuffer, mbLen) != 0) {
+		++modbusErrors;
+		StartReceiving();
+		return;
+	}
+
+	byte station = mbBuffer[0];
+	if (station != modbusAddress && station != 0) {
+		// Someone else's.
+		StartReceiving();
+		return;
+	}
+
+	byte len = HandleRequest();
+
+	if (station == 0)
+		// Broadcasts aren't answered.
+		StartReceiving();
+	else
+		SendResponse(len);
+}
@@ -0,0 +1,130 @@
+/* modbus.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	A Modbus RTU slave, on the EUSART.
+
+	The registers are two arrays, modbusHolding and modbusInput, which the application
+	reads and writes directly; this module answers the master's requests for them.
+	Supported functions:
+
+		3 - Read Holding Registers
+		4 - Read Input Registers
+		6 - Write Single Register
+		16 - Write Multiple Registers
+
+	Anything else gets an Illegal Function exception, and addresses outside the arrays
+	get an Illegal Data Address exception.  Writes to address 0 (broadcast) are carried out,
+	but not answered.
+
+	Bytes are received into a frame buffer by the interrupt, and a frame is over when
+	the line has been quiet for 3.5 character times (timed from the ms tick).
+	The main loop then checks the CRC and handles the request in place,
+	and the response is sent from the interrupt.  So nothing blocks,
+	and the reply starts as soon as the main loop gets to UpdateModbus() -
+	a few ms after the request, if it's called often.
+
+	The line is 8 data bits, no parity, 1 stop bit.
+	This takes over the EUSART, so don't use it along with serial.h.
+
+	Sample code:
+
+		void interrupt(void)
+		{
+			ModbusInterrupt();
+
+			byte ms = UiTimeInterrupt();
+			while (ms--)
+				ModbusTickMs();
+		}
+
+		...
+		InitModbus(17);
+		while (1) {
+			modbusInput[0] = temperature;
+			UpdateModbus();
+			if (modbusHoldingWritten) {
+				modbusHoldingWritten = false;
+				setpoint = modbusHolding[0];
+			}
+			...
+		}
+
+	Change the registers only from the main loop, so the master never sees half of a new value.
+
+	Requires modbus-consts.h, customized from modbus-consts-template.h.
+*/
+
+#ifndef __MODBUS_H
+#define __MODBUS_H
+
+#ifdef IN_MODBUS
+ #define MODBUS_EXTERN
+#else
+ #define MODBUS_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+#include "modbus-consts.h"
+
+
+// Exception codes.
+#define MODBUS_ILLEGAL_FUNCTION  1
+#define MODBUS_ILLEGAL_ADDRESS  2
+#define MODBUS_ILLEGAL_VALUE  3
+
+
+// The registers, in order from MODBUS_HOLDING_START and MODBUS_INPUT_START.
+MODBUS_EXTERN unsigned short modbusHolding[MODBUS_HOLDING_COUNT];
+MODBUS_EXTERN unsigned short modbusInput[MODBUS_INPUT_COUNT];
+
+// Set whenever the master writes any holding registers.
+// Clear it when you've acted on them.
+MODBUS_EXTERN byte modbusHoldingWritten;
+
+// This slave's address, 1 - 247.
+MODBUS_EXTERN byte modbusAddress;
+
+// Counts of frames received with bad CRCs or too many bytes, for diagnostics.
+MODBUS_EXTERN byte modbusErrors;
+
+
+// Sets up the EUSART, and starts listening for requests to the given address.
+// Set GIE afterwards.
+void InitModbus(byte address);
+
+// Call this from the interrupt handler.
+// Handles the EUSART's receive and transmit interrupts.
+void ModbusInterrupt(void);
+
+// Call this from the interrupt handler once per ms, e.g. for each ms returned by UiTimeInterrupt().
+// Detects the ends of frames.
+void ModbusTickMs(void);
+
+// Call this often from the main loop.
+// Handles a request if one has come in, and starts the response.
+void UpdateModbus(void);
+
+// Returns the Modbus CRC-16 of the given bytes.
+// Its low byte is sent first.
+// A frame with its CRC on the end gives a CRC of 0.
+unsigned short ModbusCrc(byte* buf, byte len);
+
+
+#endif
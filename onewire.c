@@ -19,6 +19,7 @@
 
 #include "onewire.h"
 #include "onewire-const.h"
+#include "profile.h"
 
 
 #define OUTPUT_LOW  { clear_bit(ow_port_, OW_PIN); ow_port = ow_port_; clear_bit(ow_tris, OW_PIN); }
@@ -34,7 +35,7 @@
 char OW_Reset()
 {
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 
 	// Low for T_RSTL >= 480 us.
 	OUTPUT_LOW;
@@ -54,7 +55,7 @@ char OW_Reset()
 	char result = ow_port.OW_PIN == 0;
 	
 	// Interrupts are OK now.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 	
 	// Allow it to complete for the remainder of T_RSTH = 480 us since Hi-Z.
 	// 480 - 60 = 420.
@@ -71,7 +72,7 @@ void OW_SendByte(unsigned char b)
 	unsigned char bitCount = 8;
 	
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 
 	sendLoop:
 		// Low for 4 us (docs say 5 us).
@@ -103,7 +104,7 @@ void OW_SendByte(unsigned char b)
 		}
 	
 	// Restore interrupts.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 	
 	OUTPUT_HIGH;
 }
@@ -113,7 +114,7 @@ byte OW_ReadBit()
 	byte result = 0;
 	
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 	
 		// Low for 6 us.
 		nop();
@@ -174,7 +175,7 @@ byte OW_ReadBit()
 		delay_10us(5);
 	
 	// Restore interrupts.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 	
 	OUTPUT_HIGH;
 	
@@ -187,7 +188,7 @@ unsigned char OW_ReadByte()
 	unsigned char result = 0;
 	
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 
 	recLoop:
 		// Low for 6 us.
@@ -254,7 +255,7 @@ unsigned char OW_ReadByte()
 		}
 	
 	// Restore interrupts.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 	
 	OUTPUT_HIGH;
 	
@@ -273,7 +274,7 @@ void OW_PowerOn()
 char OW_Reset_2()
 {
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 
 	// Low for T_RSTL >= 480 us.
 	OUTPUT_LOW_2;
@@ -294,7 +295,7 @@ char OW_Reset_2()
 	char result = ow_port.OW_PIN_2 == 0;
 	
 	// Interrupts are OK now.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 	
 	// Allow it to complete for the remainder of T_RSTH = 480 us since Hi-Z.
 	// 480 - 60 = 420.
@@ -312,7 +313,7 @@ void OW_SendByte_2(unsigned char b)
 	unsigned char bitCount = 8;
 	
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 
 	sendLoop2:
 		// Low for 4 us (docs say 5 us).
@@ -344,7 +345,7 @@ void OW_SendByte_2(unsigned char b)
 		}
 	
 	// Restore interrupts.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 
 	OUTPUT_HIGH_2;
 }
@@ -354,7 +355,7 @@ byte OW_ReadBit_2()
 	byte result = 0;
 	
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 	
 		// Low for 6 us.
 		nop();
@@ -415,7 +416,7 @@ byte OW_ReadBit_2()
 		delay_10us(5);
 	
 	// Restore interrupts.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 	
 	OUTPUT_HIGH_2;
 
@@ -428,7 +429,7 @@ unsigned char OW_ReadByte_2()
 	unsigned char result = 0;
 	
 	// Disable interrupts.
-	intcon.GIE = 0;
+	PROFILE_GIE_OFF(PROFILE_ONEWIRE);
 
 	recLoop2:
 		// Low for 6 us.
@@ -495,7 +496,7 @@ unsigned char OW_ReadByte_2()
 		}
 	
 	// Restore interrupts.
-	intcon.GIE = 1;
+	PROFILE_GIE_ON(PROFILE_ONEWIRE);
 	
 	OUTPUT_HIGH_2;
 
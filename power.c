@@ -0,0 +1,86 @@
+/* power.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_POWER
+
+#include <system.h>
+
+#include "power.h"
+
+
+#ifdef USE_POWER
+
+#if defined(_PIC18F2620) || defined(_PIC18F2320) || defined(_PIC18F1320) || defined(_PIC18F2550)
+ #define POWER_PIC18
+#endif
+
+
+void InitPower(void)
+{
+	powerBusy = 0;
+	powerClocks = 0;
+	powerIdleCount = 0;
+	powerSleepCount = 0;
+	
+	#ifdef POWER_AWAKE_PIN
+	POWER_AWAKE_PORT.POWER_AWAKE_PIN = 1;
+	#endif
+}
+
+void PowerSleep(void)
+{
+	// With GIE off, an interrupt still wakes the CPU, but isn't serviced until GIE is set again below.
+	// And if one is already pending, SLEEP acts as a NOP.
+	// So nothing that happens after the check below can be slept through.
+	intcon.GIE = 0;
+	
+	if (powerBusy) {
+		intcon.GIE = 1;
+		return;
+	}
+	
+	#ifdef POWER_PIC18
+	if (powerClocks) {
+		osccon.IDLEN = 1;
+		++powerIdleCount;
+	} else {
+		osccon.IDLEN = 0;
+		++powerSleepCount;
+	}
+	#else
+	if (powerClocks) {
+		intcon.GIE = 1;
+		return;
+	}
+	++powerSleepCount;
+	#endif
+	
+	#ifdef POWER_AWAKE_PIN
+	POWER_AWAKE_PORT.POWER_AWAKE_PIN = 0;
+	#endif
+	
+	sleep();
+	nop();  // executed on wake, before anything else
+	
+	#ifdef POWER_AWAKE_PIN
+	POWER_AWAKE_PORT.POWER_AWAKE_PIN = 1;
+	#endif
+	
+	intcon.GIE = 1;
+}
+
+#endif
@@ -0,0 +1,116 @@
+/* power.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Low-power main loop: sleeps between interrupts whenever nothing needs the CPU.
+
+	Each module says what it needs, with one bit per module:
+	- "Busy" means there's work for the main loop right now; don't sleep at all.
+	- "Clock" means a peripheral or timer needs the instruction clock to keep running -
+		e.g. Timer 0 for uiTime, Timer 1 for Sound, or the EUSART for serial receive.
+		On the 18F, the CPU can still IDLE (core stopped, peripherals clocked);
+		on the 16F, which has no idle mode, it stays awake.
+	With neither, the CPU SLEEPs, until a pin change, external interrupt, or the WDT wakes it.
+
+	Call PowerSleep() at the end of each pass through the main loop.
+	It returns after the next interrupt has been handled, so every interrupt
+	gets one more pass through the loop to act on it:
+
+		while (1) {
+			CheckStuff();
+			UpdateSong();
+			...
+			PowerSleep();
+		}
+
+	Sound, serial, buttons, CapSense, and DallasTemp's task versions set and clear their own bits.
+	The buttons hold the clock all the time, unless BUTTONS_WAKE_ON_CHANGE (buttons-consts.h)
+	lets a press wake the CPU.
+	Set POWER_TIME yourself if uiTime's ms count has to keep running while nothing else is going on.
+
+	Define USE_POWER in your project to turn this on.  Without it, the module hooks
+	compile to nothing, and modules can include this header unconditionally.
+
+	Wake latency:
+	- From IDLE, the ISR starts within a few instruction cycles of the wake event.
+	- From SLEEP, the oscillator has to restart first: 1024 oscillator periods for
+		XT, HS, or LP crystals, or a few us for the internal oscillator (see "Oscillator Start-up Timer").
+	To measure it, define POWER_AWAKE_PORT and POWER_AWAKE_PIN: that pin is held low while
+	the CPU is stopped, so a scope shows both the latency from a wake event and the duty cycle.
+*/
+
+#ifndef __POWER_H
+#define __POWER_H
+
+#ifdef IN_POWER
+ #define POWER_EXTERN
+#else
+ #define POWER_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+
+// The modules' bits, for the busy and clock masks.
+#define POWER_SOUND  0x01
+#define POWER_SERIAL  0x02
+#define POWER_TEMP  0x04
+#define POWER_BUTTONS  0x08
+#define POWER_CAPSENSE  0x10
+#define POWER_TIME  0x20
+#define POWER_APP1  0x40  // for the application's own use
+#define POWER_APP2  0x80
+
+
+#ifdef USE_POWER
+
+// Modules needing the main loop now.
+POWER_EXTERN byte powerBusy;
+
+// Modules needing the instruction clock.
+POWER_EXTERN byte powerClocks;
+
+// How many times the CPU has idled and slept, for working out the duty cycle.
+POWER_EXTERN unsigned short powerIdleCount;
+POWER_EXTERN unsigned short powerSleepCount;
+
+// Use constant masks, so these are single instructions and safe from an ISR.
+#define PowerSetBusy(mask)  (powerBusy |= (mask))
+#define PowerClearBusy(mask)  (powerBusy &= ~(mask))
+#define PowerNeedClock(mask)  (powerClocks |= (mask))
+#define PowerReleaseClock(mask)  (powerClocks &= ~(mask))
+
+// Call this once, before the main loop.
+void InitPower(void);
+
+// Call this at the end of each pass through the main loop.
+// Stops the CPU until the next interrupt, as far as the modules allow.
+void PowerSleep(void);
+
+#else
+
+// As expressions, so "if (...) PowerNeedClock(...); else ..." still reads as a statement.
+#define PowerSetBusy(mask)  ((void) 0)
+#define PowerClearBusy(mask)  ((void) 0)
+#define PowerNeedClock(mask)  ((void) 0)
+#define PowerReleaseClock(mask)  ((void) 0)
+
+#endif
+
+
+#endif
@@ -0,0 +1,9 @@
+// pqueue-consts.h
+
+// Define this to suit your application.
+typedef struct {
+	unsigned char command;
+} PQueueEntry;
+
+// Each entry costs 3 bytes of RAM beyond the record itself.  Max 127.
+#define PQUEUE_LENGTH  8
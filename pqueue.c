@@ -0,0 +1,86 @@
+/* pqueue.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_PQUEUE
+
+#include <system.h>
+
+#include "pqueue.h"
+
+
+// Returns true if deadline a comes before b, allowing for rollover.
+inline byte PQueueBefore(unsigned short a, unsigned short b)
+{
+	return (signed short)(a - b) < 0;
+}
+
+void ClearPQueue(void)
+{
+	byte i;
+	for (i = 0; i < PQUEUE_LENGTH; ++i)
+		pqHeap[i] = i;
+	pqCount = 0;
+}
+
+void PushPQueue(unsigned short deadline)
+{
+	byte slot = pqHeap[pqCount];
+	pqDeadline[slot] = deadline;
+
+	// Move parents down until there's one that's due no later, then put the new one under it.
+	byte i = pqCount++;
+	while (i) {
+		byte parent = (i - 1) >> 1;
+		byte parentSlot = pqHeap[parent];
+		if (!PQueueBefore(deadline, pqDeadline[parentSlot]))
+			break;
+		pqHeap[i] = parentSlot;
+		i = parent;
+	}
+	pqHeap[i] = slot;
+}
+
+void PopPQueue(void)
+{
+	// The head's record goes to the free end, and the last heap element
+	// sifts down from the top to take its place.
+	byte freed = pqHeap[0];
+	byte last = pqHeap[--pqCount];
+	pqHeap[pqCount] = freed;
+
+	if (!pqCount)
+		return;
+
+	unsigned short deadline = pqDeadline[last];
+	byte i = 0;
+	while (1) {
+		byte child = (i << 1) + 1;
+		if (child >= pqCount)
+			break;
+
+		// Follow the earlier of the two children.
+		byte childSlot = pqHeap[child];
+		if (child + 1 < pqCount && PQueueBefore(pqDeadline[pqHeap[child + 1]], pqDeadline[childSlot]))
+			childSlot = pqHeap[++child];
+
+		if (!PQueueBefore(pqDeadline[childSlot], deadline))
+			break;
+		pqHeap[i] = childSlot;
+		i = child;
+	}
+	pqHeap[i] = last;
+}
@@ -0,0 +1,120 @@
+/* pqueue.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	A priority queue of user-definable records, ordered by deadline.
+	Items come out earliest deadline first, rather than in the order they went in
+	as with queue.h - handy for retries, timeouts, and staged actions.
+
+	The record type is declared in pqueue-consts.h (customized per application
+	from pqueue-consts-template.h), and as with queue.h, only one can be used per application.
+
+	Deadlines are unsigned shorts in whatever units the application likes -
+	usually taskMs (task.h) or wheelNow (timerWheel.h).  They're compared across rollover,
+	so all the deadlines in the queue must be within 32767 of each other.
+
+	Items are kept in a binary heap, so pushing and popping take time proportional to
+	log2 of the number of items, and finding the next deadline takes none at all.
+	Records stay where they are; only their one-byte indices move around the heap.
+	Items with the same deadline come out in no particular order.
+
+	As in queue.h, a new element is reserved, filled in place, then committed:
+
+		if (!IsPQueueFull()) {
+			PQueueTail()->command = RETRY_SEND;
+			PushPQueue(TaskNowMs() + 500);
+		}
+
+	And the main loop handles whatever's due, then can sleep until the next deadline:
+
+		while (IsPQueueDue(TaskNowMs())) {
+			DoCommand(PQueueHead()->command);
+			PopPQueue();
+		}
+*/
+
+#ifndef _PQUEUE_H_
+#define _PQUEUE_H_
+
+#include "types-tjw.h"
+
+#include "pqueue-consts.h"
+
+#ifdef IN_PQUEUE
+ #define PQUEUE_EXTERN
+#else
+ #define PQUEUE_EXTERN  extern
+#endif
+
+
+// These are only intended for use within the PQueue module,
+// but the inline function definitions need them to be visible here.
+PQUEUE_EXTERN PQueueEntry pqueue[PQUEUE_LENGTH];
+
+// Each record's deadline, by its index in pqueue.
+PQUEUE_EXTERN unsigned short pqDeadline[PQUEUE_LENGTH];
+
+// The first pqCount elements are the heap, of indices into pqueue;
+// each one's deadline is no later than those of its children, at 2i + 1 and 2i + 2.
+// The rest are the indices of the free records, so the next one to fill is always at pqCount.
+PQUEUE_EXTERN byte pqHeap[PQUEUE_LENGTH];
+PQUEUE_EXTERN byte pqCount;
+
+// Empties the queue.  Call this once before using it.
+void ClearPQueue(void);
+
+#define IsPQueueEmpty()  (pqCount == 0)
+
+#define IsPQueueFull()  (pqCount == PQUEUE_LENGTH)
+
+// Returns the record with the earliest deadline.
+// Only valid if the queue isn't empty.
+inline PQueueEntry* PQueueHead(void)
+{
+	return &pqueue[pqHeap[0]];
+}
+
+// Returns the earliest deadline in the queue.
+// Only valid if the queue isn't empty.
+inline unsigned short PQueueNextDeadline(void)
+{
+	return pqDeadline[pqHeap[0]];
+}
+
+// Returns true if the queue isn't empty and its earliest deadline has arrived.
+inline byte IsPQueueDue(unsigned short now)
+{
+	return pqCount && (signed short)(now - PQueueNextDeadline()) >= 0;
+}
+
+// Returns the record that will be added by the next PushPQueue(), to be filled in first.
+// Only valid if the queue isn't full.
+inline PQueueEntry* PQueueTail(void)
+{
+	return &pqueue[pqHeap[pqCount]];
+}
+
+// Accepts the record prepared at PQueueTail() into the queue, with the given deadline.
+// Only valid if the queue isn't full.
+void PushPQueue(unsigned short deadline);
+
+// Removes the record with the earliest deadline.
+// Only valid if the queue isn't empty.
+void PopPQueue(void);
+
+
+#endif
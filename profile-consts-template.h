@@ -0,0 +1,28 @@
+// profile-consts.h
+// Customize this to fit your application.
+
+
+#ifndef __PROFILE_CONSTS
+#define __PROFILE_CONSTS
+
+// The free-running 16-bit timer to time with, at 1:1 on the instruction clock.
+// Start it yourself, e.g. t1con = 0x01.  It mustn't be reloaded by anyone else,
+// so if Sound or CapSense has Timer 1, use Timer 3 on the 18F.
+#define PROFILE_TIMER_L  tmr1l
+#define PROFILE_TIMER_H  tmr1h
+
+// The slots, sequential from 0: one per handler or critical section to profile.
+// The library modules' slots can be set to PROFILE_NONE to leave them out.
+#define PROFILE_ONEWIRE  0  // interrupts masked by onewire.c
+#define PROFILE_EEPROM  1  // interrupts masked by write_eeprom()
+#define PROFILE_BLOCKING_SOUND  2  // interrupts masked by BlockingSound
+#define PROFILE_SERIAL_SEND  PROFILE_NONE  // interrupts masked by TryWriteSerial(), with SERIAL_XONXOFF or SERIAL_TX_QUEUE_LENGTH
+#define PROFILE_ISR  3  // e.g. the whole interrupt handler
+#define PROFILE_T0_LATENCY  4  // e.g. from Timer 0's rollover to the handler
+
+// The number of slots - one more than the last one.
+// Each one costs 10 bytes of RAM.
+#define NUM_PROFILE_SLOTS  5
+
+
+#endif
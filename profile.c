@@ -0,0 +1,150 @@
+/* profile.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_PROFILE
+
+#include <system.h>
+
+#include "profile.h"
+#include "serial.h"
+
+
+#ifdef USE_PROFILE
+
+static unsigned short profileCount[NUM_PROFILE_SLOTS];
+static unsigned short profileMin[NUM_PROFILE_SLOTS];
+static unsigned short profileMax[NUM_PROFILE_SLOTS];
+static unsigned long profileTotal[NUM_PROFILE_SLOTS];
+
+// The cycles taken by PROFILE_BEGIN and ProfileEnd themselves, measured at startup.
+static unsigned short profileOverhead;
+
+#define OVERHEAD_SLOT  0
+
+
+void ProfileReset(void)
+{
+	// May be called with interrupts masked, so leave them that way.
+	byte i;
+	byte gie;
+	for (i = 0; i < NUM_PROFILE_SLOTS; ++i) {
+		PROFILE_GIE_SAVE(PROFILE_NONE, gie);
+		profileCount[i] = 0;
+		profileMin[i] = 0xFFFF;
+		profileMax[i] = 0;
+		profileTotal[i] = 0;
+		PROFILE_GIE_RESTORE(PROFILE_NONE, gie);
+	}
+}
+
+void InitProfile(void)
+{
+	// Time an empty measurement; everything after will have that taken off.
+	profileOverhead = 0;
+	ProfileReset();
+	
+	byte gie;
+	PROFILE_GIE_SAVE(PROFILE_NONE, gie);
+	PROFILE_BEGIN(OVERHEAD_SLOT);
+	PROFILE_END(OVERHEAD_SLOT);
+	profileOverhead = profileMin[OVERHEAD_SLOT];
+	PROFILE_GIE_RESTORE(PROFILE_NONE, gie);
+	
+	ProfileReset();
+}
+
+void ProfileSample(byte slot, unsigned short cycles)
+{
+	// Saturate, rather than wrapping the average.
+	if (profileCount[slot] == 0xFFFF)
+		return;
+	++profileCount[slot];
+	
+	if (cycles < profileMin[slot])
+		profileMin[slot] = cycles;
+	if (cycles > profileMax[slot])
+		profileMax[slot] = cycles;
+	profileTotal[slot] += cycles;
+}
+
+void ProfileEnd(byte slot)
+{
+	unsigned short cycles = ProfileNow() - profileStart[slot];
+	
+	if (cycles > profileOverhead)
+		cycles -= profileOverhead;
+	else
+		cycles = 0;
+	
+	ProfileSample(slot, cycles);
+}
+
+// Takes as many of the given power of 10 out of n as it can, and writes that digit
+// unless it's a leading zero.
+static void WriteDigit(unsigned short& n, unsigned short power, byte& started)
+{
+	char digit = '0';
+	while (n >= power) {
+		n -= power;
+		++digit;
+	}
+	if (digit != '0' || started) {
+		WriteSerial(digit);
+		started = true;
+	}
+}
+
+// Writes the given number in decimal, without dividing.
+static void WriteDecimal(unsigned short n)
+{
+	byte started = false;
+	WriteDigit(n, 10000, started);
+	WriteDigit(n, 1000, started);
+	WriteDigit(n, 100, started);
+	WriteDigit(n, 10, started);
+	WriteSerial('0' + (byte) n);
+}
+
+void ProfileReport(void)
+{
+	byte i;
+	for (i = 0; i < NUM_PROFILE_SLOTS; ++i) {
+		// Copy the slot, so the ISR can't change it partway through.
+		intcon.GIE = 0;
+		unsigned short count = profileCount[i];
+		unsigned short min = profileMin[i];
+		unsigned short max = profileMax[i];
+		unsigned long total = profileTotal[i];
+		intcon.GIE = 1;
+		
+		WriteDecimal(i);
+		WriteSerial(' ');
+		WriteDecimal(count);
+		if (count) {
+			WriteSerial(' ');
+			WriteDecimal(min);
+			WriteSerial(' ');
+			WriteDecimal(total / count);
+			WriteSerial(' ');
+			WriteDecimal(max);
+		}
+		WriteSerial('\r');
+		WriteSerial('\n');
+	}
+}
+
+#endif
@@ -0,0 +1,139 @@
+/* profile.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Execution-time and latency profiling, for checking real-time budgets.
+
+	Bracket the code of interest with PROFILE_BEGIN and PROFILE_END, giving each
+	piece its own slot.  Each slot keeps the count, min, max, and total of the
+	cycles between them, read from a free-running 16-bit timer, less the cost of
+	the timing itself.  So each measurement must be under 65536 cycles.
+
+	For critical sections, use PROFILE_GIE_OFF and PROFILE_GIE_ON in place of
+	setting intcon.GIE, or PROFILE_GIE_SAVE and PROFILE_GIE_RESTORE where interrupts
+	may already be masked; onewire, eeprom-tjw, BlockingSound, and serial already do.
+
+	Timer-driven interrupt latency can be measured directly, since the timer counts
+	on from its rollover: PROFILE_T0_SAMPLE at the top of the handler records how
+	long ago Timer 0 rolled over (assuming it's driven by uiTime).
+
+	ProfileReport() writes a line per slot out the serial port:
+		slot count min avg max
+	in cycles, in decimal.  Call it when asked, e.g. on receiving a 'p'.
+
+	Define USE_PROFILE in your project to turn this on.  Without it, the macros
+	compile to nothing (or just to the GIE change), so they can be left in.
+
+	Sample code:
+
+		void interrupt(void)
+		{
+			PROFILE_T0_SAMPLE(PROFILE_T0_LATENCY);
+			PROFILE_BEGIN(PROFILE_ISR);
+			...
+			PROFILE_END(PROFILE_ISR);
+		}
+
+	Requires profile-consts.h, customized from profile-consts-template.h,
+	and serial with transmit enabled.
+*/
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#ifdef IN_PROFILE
+ #define PROFILE_EXTERN
+#else
+ #define PROFILE_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+
+// Use this for a library module's slot, in profile-consts.h, to leave it out.
+#define PROFILE_NONE  0xFF
+
+
+#ifdef USE_PROFILE
+
+#include "profile-consts.h"
+#include "uiTime.h"
+
+#if defined(_PIC18F2620) || defined(_PIC18F2320) || defined(_PIC18F1320) || defined(_PIC18F2550)
+ #define PROFILE_TMR0  tmr0l
+#else
+ #define PROFILE_TMR0  tmr0
+#endif
+
+// The start time of each slot's current measurement.
+PROFILE_EXTERN unsigned short profileStart[NUM_PROFILE_SLOTS];
+
+// Reads the timer.
+// The high byte is read on both sides of the low byte, in case the low byte rolls over in between.
+inline unsigned short ProfileNow(void)
+{
+	byte high = PROFILE_TIMER_H;
+	byte low = PROFILE_TIMER_L;
+	byte high2 = PROFILE_TIMER_H;
+	if (high2 != high)
+		low = PROFILE_TIMER_L;
+
+	unsigned short result;
+	MAKESHORT(result, low, high2);
+	return result;
+}
+
+// Call this once, after starting the timer.  Also clears the statistics.
+void InitProfile(void);
+
+// Clears the statistics.
+void ProfileReset(void);
+
+// Adds a measurement of the given number of cycles to the given slot.
+void ProfileSample(byte slot, unsigned short cycles);
+
+// Ends a measurement started with PROFILE_BEGIN.
+void ProfileEnd(byte slot);
+
+// Writes the statistics out the serial port.
+// Waits while the serial port can't send; see SERIAL_TX_QUEUE_LENGTH in serial.h.
+void ProfileReport(void);
+
+#define PROFILE_BEGIN(slot)  { if ((slot) != PROFILE_NONE) profileStart[slot] = ProfileNow(); }
+#define PROFILE_END(slot)  { if ((slot) != PROFILE_NONE) ProfileEnd(slot); }
+#define PROFILE_T0_SAMPLE(slot)  { if ((slot) != PROFILE_NONE) ProfileSample(slot, (unsigned short) PROFILE_TMR0 * UITIME_T0_PRESCALE); }
+
+#else
+
+#define PROFILE_BEGIN(slot)
+#define PROFILE_END(slot)
+#define PROFILE_T0_SAMPLE(slot)
+
+#endif
+
+// These time a critical section, from just after interrupts are masked to just before they're unmasked.
+#define PROFILE_GIE_OFF(slot)  { intcon.GIE = 0; PROFILE_BEGIN(slot); }
+#define PROFILE_GIE_ON(slot)  { PROFILE_END(slot); intcon.GIE = 1; }
+
+// The same, for one that may be entered with interrupts already masked:
+// the state of GIE is kept in the given byte, and put back at the end.
+#define PROFILE_GIE_SAVE(slot, gie)  { gie = intcon.GIE; intcon.GIE = 0; PROFILE_BEGIN(slot); }
+#define PROFILE_GIE_RESTORE(slot, gie)  { PROFILE_END(slot); intcon.GIE = gie; }
+
+
+#endif
@@ -6,3 +6,10 @@ typedef struct {
 } QueueEntry;
 
 #define QUEUE_LENGTH  5
+
+// Define this for coalescing pushes (see queue.h), as the number of distinct keys.
+// QueueEntry then needs a byte field named key, from 0 to QUEUE_KEYS - 1.
+//#define QUEUE_KEYS  4
+
+// For eeQueue.h: where the queue is kept in EEPROM.
+//#define EEQUEUE_ADDR  0x00
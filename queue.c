@@ -24,7 +24,7 @@
 QueueEntry* QueueIncrement(QueueEntry* queueIndex)
 {
 	if (queueIndex == &queue[QUEUE_LENGTH - 1])
-		return &queue;
+		return &queue[0];
 	else
 		return ++queueIndex;
 }
@@ -36,11 +36,42 @@ void PrePushQueue(void)
 	}
 }
 
+#ifdef QUEUE_KEYS
+void ClearQueueKeys(void)
+{
+	byte i;
+	for (i = 0; i < QUEUE_KEYS; ++i)
+		queueKeyed[i] = 0;
+}
+
+// Forgets the keyed entries other than the head, after everything else has been discarded.
+static void KeepHeadKey(void)
+{
+	byte wasKeyed = queueKeyed[queueHead->key] == queueHead;
+	ClearQueueKeys();
+	if (wasKeyed)
+		queueKeyed[queueHead->key] = queueHead;
+}
+
+QueueEntry* PrePushQueueKeyed(byte key)
+{
+	QueueEntry* result = queueKeyed[key];
+	if (!result) {
+		PrePushQueue();
+		result = queueTail;
+	}
+	return result;
+}
+#endif
+
 void PrePushQueueKeepHead(void)
 {
 	if (IsQueueFull()) {
 		queueTail = QueueNextHead();
 		queueCount = 1;
+		#ifdef QUEUE_KEYS
+		KeepHeadKey();
+		#endif
 	}
 }
 
@@ -49,5 +80,8 @@ void ClearQueueTail(void)
 	if (!IsQueueEmpty()) {
 		queueTail = QueueNextHead();
 		queueCount = 1;
+		#ifdef QUEUE_KEYS
+		KeepHeadKey();
+		#endif
 	}
 }
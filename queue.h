@@ -45,6 +45,19 @@
 		putc(QueueHead()->b);
 		PopQueue();
 		
+	Coalescing mode, for when only the newest value of each kind matters
+	(sensor readings, display updates):  define QUEUE_KEYS in queue-consts.h
+	as the number of distinct keys, and give QueueEntry a byte field named key.
+	Then push with the Keyed calls, and an entry with the same key that's still
+	waiting is overwritten in place, keeping its place in line, instead of
+	adding another one:
+	
+		QueueEntry* e = PrePushQueueKeyed(TEMP_KEY);
+		e->value = reading;
+		PushQueueKeyed(TEMP_KEY);
+	
+	The rest of the API is unchanged.  Plain pushes can be mixed in, as long as
+	they set a valid key; they just aren't coalesced.
 */
 
 #ifndef _QUEUE_H_
@@ -74,6 +87,14 @@ QUEUE_EXTERN QueueEntry* queueHead;
 QUEUE_EXTERN QueueEntry* queueTail;
 QUEUE_EXTERN byte queueCount;
 
+#ifdef QUEUE_KEYS
+// The queued entry for each key, or 0 if none is waiting.
+QUEUE_EXTERN QueueEntry* queueKeyed[QUEUE_KEYS];
+
+// Forgets all the keyed entries.
+void ClearQueueKeys(void);
+#endif
+
 // Returns a pointer to the next queue element after the given one,
 // wrapping around.
 QueueEntry* QueueIncrement(QueueEntry* queueIndex);
@@ -83,6 +104,9 @@ inline void ClearQueue(void)
 	queueHead = &queue[0];
 	queueTail = queueHead;
 	queueCount = 0;
+	#ifdef QUEUE_KEYS
+	ClearQueueKeys();
+	#endif
 }
 
 // Clears everything from the queue but the head.
@@ -134,9 +158,31 @@ inline void PushQueue(void)
 // Removes the head from the queue.
 inline void PopQueue(void)
 {
+	#ifdef QUEUE_KEYS
+	if (queueKeyed[queueHead->key] == queueHead)
+		queueKeyed[queueHead->key] = 0;
+	#endif
 	queueHead = QueueNextHead();
 	--queueCount;
 }
 
 
+#ifdef QUEUE_KEYS
+// Returns the waiting entry with the given key, to be overwritten with the new value;
+// or if there isn't one, makes space at the tail as PrePushQueue() does, and returns that.
+// Either way, fill it in (including key), then call PushQueueKeyed() with the same key.
+QueueEntry* PrePushQueueKeyed(byte key);
+
+// Accepts the entry from PrePushQueueKeyed().
+// Only adds to the queue if there wasn't already an entry with this key.
+inline void PushQueueKeyed(byte key)
+{
+	if (!queueKeyed[key]) {
+		queueKeyed[key] = queueTail;
+		PushQueue();
+	}
+}
+#endif
+
+
 #endif
\ No newline at end of file
@@ -2,3 +2,43 @@
 
 // The number of bytes to reserve for the input queue.
 #define SERIAL_QUEUE_LENGTH  17
+
+// Define this to send through an output queue of this many bytes (up to 127),
+// drained by the interrupt, so WriteSerial() only waits when it's full.
+//#define SERIAL_TX_QUEUE_LENGTH  32
+
+// The bit rate to start at.  Defaults to 9600.
+//#define SERIAL_BAUD  9600
+
+// Define this to get DetectSerialBaud().
+//#define SERIAL_AUTOBAUD
+
+// On chips without an EUSART, DetectSerialBaud() times the bits on the receive pin.
+// This is RB1 on the 16F627/628/648.
+//#define SERIAL_RX_PIN  portb.1
+
+// Define this for an RS-485 bus, with 9-bit addressing.  No flow control on a bus.
+//#define SERIAL_RS485
+
+// The pin that enables the RS-485 driver, active high.
+//#define SERIAL_DE_PORT  portc
+//#define SERIAL_DE_TRIS  trisc
+//#define SERIAL_DE_BIT  5
+
+// Define one of these for flow control.
+//#define SERIAL_RTSCTS
+//#define SERIAL_XONXOFF
+
+// Tell the other end to stop when the input queue has this many bytes,
+// and to go on when it's down to this many.
+// Leave room above SERIAL_FLOW_HIGH for what it sends before it notices.
+#define SERIAL_FLOW_HIGH  (SERIAL_QUEUE_LENGTH - 5)
+#define SERIAL_FLOW_LOW  (SERIAL_QUEUE_LENGTH / 4)
+
+// The RTS output (high to stop the other end) and CTS input (high when we should stop),
+// for SERIAL_RTSCTS.
+//#define SERIAL_RTS_PORT  portc
+//#define SERIAL_RTS_TRIS  trisc
+//#define SERIAL_RTS_BIT  5
+//#define SERIAL_CTS_PORT  portc
+//#define SERIAL_CTS_BIT  4
@@ -25,7 +25,38 @@
 #include <system.h>
 
 #include "serial.h"
-#include "serial-consts.h"
+#include "power.h"
+
+
+#ifndef SERIAL_BAUD
+ #define SERIAL_BAUD  9600
+#endif
+
+#if SERIAL_BRG(SERIAL_BAUD) < 1 || (!defined(SERIAL_BAUDCTL) && SERIAL_BRG(SERIAL_BAUD) > 255)
+ #error "serial.c - SERIAL_BAUD is out of range for this oscillator"
+#endif
+
+#if defined(SERIAL_RTSCTS) || defined(SERIAL_XONXOFF)
+ #define SERIAL_FLOW
+
+ #ifndef SERIAL_FLOW_HIGH
+  #define SERIAL_FLOW_HIGH  (SERIAL_QUEUE_LENGTH - 5)
+ #endif
+ #ifndef SERIAL_FLOW_LOW
+  #define SERIAL_FLOW_LOW  (SERIAL_QUEUE_LENGTH / 4)
+ #endif
+#endif
+
+#if (defined(SERIAL_XONXOFF) || defined(SERIAL_RTSCTS)) && defined(SERIAL_RS485)
+ #error "serial.c - flow control can't be used on an RS-485 bus"
+#endif
+
+#if defined(SERIAL_TX_QUEUE_LENGTH) && SERIAL_TX_QUEUE_LENGTH > 127
+ #error "serial.c - SERIAL_TX_QUEUE_LENGTH is at most 127"
+#endif
+
+#define XON  0x11
+#define XOFF  0x13
 
 
 #ifdef SOFTWARE_RECEIVE
@@ -65,6 +96,58 @@
 	
 #endif
 
+#ifdef SERIAL_TX_QUEUE_LENGTH
+	// The output queue, filled by TryWriteSerial() and emptied by the interrupt.
+	// txHead is the next byte to send, and txCount the number waiting.
+	static unsigned char txQueue[SERIAL_TX_QUEUE_LENGTH];
+	static byte txHead;
+	static volatile byte txCount;
+#endif
+
+#ifdef SERIAL_FLOW
+	// Set after we've told the other end to stop.
+	static bit flowStopped;
+	
+	#ifdef SERIAL_XONXOFF
+		// The XON or XOFF for the interrupt to send, when TXIE is set; 0 when there's none.
+		static char flowSend;
+	#endif
+	
+// Returns the number of bytes in the input queue.
+inline byte QueueFill(void)
+{
+	byte fill = dataQueueTail - dataQueueHead;
+	if (dataQueueTail < dataQueueHead)
+		fill += SERIAL_QUEUE_LENGTH;
+	return fill;
+}
+
+// Tells the other end to stop, or to go on.
+inline void SetFlowStopped(byte stop)
+{
+	flowStopped = stop;
+	#ifdef SERIAL_RTSCTS
+		if (stop)
+			set_bit(SERIAL_RTS_PORT, SERIAL_RTS_BIT);
+		else
+			clear_bit(SERIAL_RTS_PORT, SERIAL_RTS_BIT);
+	#else
+		flowSend = stop ? XOFF : XON;
+		pie1.TXIE = 1;
+	#endif
+}
+#endif
+
+// Sets the baud rate generator.
+inline void LoadBrg(unsigned short brg)
+{
+	ser_brg = brg;
+	#ifdef SERIAL_BAUDCTL
+		HIBYTE(spbrgh, brg);
+	#endif
+	LOBYTE(spbrg, brg);
+}
+
 void InitializeSerial()
 {
 	InitializeSerial2(true, false);
@@ -82,10 +165,44 @@ void InitializeSerial2(bool useReceive, bool useTransmit)
 	
 	#else
 
-		// Set for 9600 baud.
-		txsta.BRGH = 1;  // Set baud rate to...
-		spbrg = 25;  // ... 9600 baud
+		// Set the baud rate.
+		txsta.BRGH = 1;
+		#ifdef SERIAL_BAUDCTL
+			SERIAL_BAUDCTL.BRG16 = 1;
+		#endif
+		LoadBrg(SERIAL_BRG(SERIAL_BAUD));
 		rcsta.SPEN = 1;  // Enable serial port.
+
+		#ifdef SERIAL_FLOW
+			flowStopped = 0;
+			#ifdef SERIAL_RTSCTS
+				clear_bit(SERIAL_RTS_PORT, SERIAL_RTS_BIT);
+				clear_bit(SERIAL_RTS_TRIS, SERIAL_RTS_BIT);
+			#endif
+		#endif
+		#ifdef SERIAL_XONXOFF
+			ser_paused = 0;
+			flowSend = 0;
+		#endif
+		#ifdef SERIAL_TX_QUEUE_LENGTH
+			txHead = 0;
+			txCount = 0;
+		#endif
+		#if defined(SERIAL_TX_QUEUE_LENGTH) || defined(SERIAL_XONXOFF) || defined(SERIAL_RS485)
+			pie1.TXIE = 0;
+		#endif
+
+		#ifdef SERIAL_RS485
+			// Off the bus until there's something to send.
+			clear_bit(SERIAL_DE_PORT, SERIAL_DE_BIT);
+			clear_bit(SERIAL_DE_TRIS, SERIAL_DE_BIT);
+			ser_transmitting = 0;
+
+			// 9 bits, and ignore everything until an address byte.
+			txsta.TX9 = 1;
+			rcsta.RX9 = 1;
+			rcsta.ADDEN = 1;
+		#endif
 		
 	#endif
 
@@ -93,11 +210,19 @@ void InitializeSerial2(bool useReceive, bool useTransmit)
 	
 	if (useTransmit) {
 		txsta.TXEN = 1;
+
+		#if defined(SERIAL_TX_QUEUE_LENGTH) || defined(SERIAL_RS485)
+			// The output queue is sent, and the bus released, from the interrupt.
+			intcon.PEIE = 1;
+		#endif
 	}
 		
 	// Receive-only stuff.
 	
 	if (useReceive) {
+		
+		// Reception needs the clock, so we can't sleep through it.
+		PowerNeedClock(POWER_SERIAL);
 	
 	#ifdef SOFTWARE_RECEIVE
 		
@@ -233,22 +358,85 @@ void SerialInterrupt()
 				ser_errorType = 'C';
 				ser_error = 1;
 				ser_hasData = 0;
-			} else if (queueNextTail == dataQueueHead) {  // queue is full
-				ser_error = 1;
-				ser_errorType = 'c';
+		#ifdef SERIAL_RS485
+			} else if (rcsta.RX9D) {
+				// An address byte; listen to the frame only if it's for us.
+				// (RX9D has to be read before rcreg.)
+				rcsta.ADDEN = (rcreg != ser_address);
+				ser_error = 0;
+		#endif
 			} else {
-				*dataQueueTail = rcreg;
-				
-				dataQueueTail = queueNextTail;
+				unsigned char c = rcreg;
 				
-				if (++queueNextTail == queueEnd)
-					queueNextTail = dataQueue;
+			#ifdef SERIAL_XONXOFF
+				if (c == XOFF || c == XON) {
+					// Flow control from the other end; not part of the data.
+					ser_paused = (c == XOFF);
+					#ifdef SERIAL_TX_QUEUE_LENGTH
+						if (!ser_paused)
+							pie1.TXIE = 1;
+					#endif
+				} else
+			#endif
+				if (queueNextTail == dataQueueHead) {  // queue is full
+					ser_error = 1;
+					ser_errorType = 'c';
+				} else {
+					*dataQueueTail = c;
 					
-				ser_error = 0;
+					dataQueueTail = queueNextTail;
+					
+					if (++queueNextTail == queueEnd)
+						queueNextTail = dataQueue;
+						
+					ser_error = 0;
+					
+				#ifdef SERIAL_FLOW
+					// Stop the other end while there's still room for what it sends before it notices.
+					if (!flowStopped && QueueFill() >= SERIAL_FLOW_HIGH)
+						SetFlowStopped(true);
+				#endif
+				}
 			}
 
-			ser_hasData = !ser_error;
+			ser_hasData = !ser_error && dataQueueHead != dataQueueTail;
 		}
+
+	#if defined(SERIAL_TX_QUEUE_LENGTH) || defined(SERIAL_XONXOFF) || defined(SERIAL_RS485)
+		// Whenever the transmitter has room: send a waiting XON or XOFF, then the output queue.
+		// Stop when there's nothing to send, or the other end has asked us to;
+		// TXIF stays set, so leaving TXIE on would just bring us straight back.
+		if (pie1.TXIE && pir1.TXIF) {
+		#ifdef SERIAL_XONXOFF
+			if (flowSend) {
+				txreg = flowSend;
+				flowSend = 0;
+				#ifndef SERIAL_TX_QUEUE_LENGTH
+					pie1.TXIE = 0;
+				#endif
+			} else
+		#endif
+		#ifdef SERIAL_TX_QUEUE_LENGTH
+			if (txCount && SerialFlowClear()) {
+				txreg = txQueue[txHead];
+				if (++txHead == SERIAL_TX_QUEUE_LENGTH)
+					txHead = 0;
+				--txCount;
+			} else
+		#endif
+		#ifdef SERIAL_RS485
+			// On the bus, keep coming back until the last stop bit is out
+			// (TRMT has no interrupt of its own), then release the driver.
+			if (txsta.TRMT) {
+				clear_bit(SERIAL_DE_PORT, SERIAL_DE_BIT);
+				ser_transmitting = 0;
+				pie1.TXIE = 0;
+			}
+		#else
+				pie1.TXIE = 0;
+		#endif
+		}
+	#endif
 		
 	#endif
 }
@@ -267,6 +455,246 @@ unsigned char ReadSerial()
 		dataQueueHead = dataQueue;
 		
 	ser_hasData = (dataQueueHead != dataQueueTail);
+	
+	#ifdef SERIAL_FLOW
+		if (flowStopped && QueueFill() <= SERIAL_FLOW_LOW)
+			SetFlowStopped(false);
+	#endif
 #endif
 	return result;
 }
+
+#ifdef SERIAL_TX_QUEUE_LENGTH
+
+byte SerialTxRoom(void)
+{
+	return SERIAL_TX_QUEUE_LENGTH - txCount;
+}
+
+byte TryWriteSerial(char c)
+{
+	if (txCount == SERIAL_TX_QUEUE_LENGTH)
+		return false;
+
+	// The interrupt takes from the queue at any time, so add to it in one go.
+	byte gie;
+	PROFILE_GIE_SAVE(PROFILE_SERIAL_SEND, gie);
+
+	byte tail = txHead + txCount;
+	if (tail >= SERIAL_TX_QUEUE_LENGTH)
+		tail -= SERIAL_TX_QUEUE_LENGTH;
+	txQueue[tail] = c;
+	++txCount;
+
+	#ifdef SERIAL_RS485
+		SerialDriverOn();
+	#endif
+	pie1.TXIE = 1;
+
+	PROFILE_GIE_RESTORE(PROFILE_SERIAL_SEND, gie);
+	return true;
+}
+
+#endif
+
+void SetSerialBrg(unsigned short brg)
+{
+#ifndef SOFTWARE_RECEIVE
+	// Let the last byte go out at the old rate.
+	// (TXIF is never set with the transmitter off, and there's nothing to wait for.)
+	if (txsta.TXEN) {
+		#ifdef SERIAL_TX_QUEUE_LENGTH
+			while (txCount)
+				;
+		#endif
+		while (!pir1.TXIF || !txsta.TRMT)
+			;
+	}
+
+	LoadBrg(brg);
+#endif
+}
+
+#ifdef SERIAL_NEGOTIATE
+
+// The rate to go back to, and when the trial started.
+static unsigned short trialBrg;
+static byte trialStart;
+static bit trialRunning;
+
+void TrySerialBrg(unsigned short brg)
+{
+	trialBrg = ser_brg;
+	SetSerialBrg(brg);
+	trialStart = ticks;
+	trialRunning = 1;
+}
+
+void KeepSerialBrg(void)
+{
+	trialRunning = 0;
+}
+
+byte UpdateSerialBrg(void)
+{
+	if (trialRunning && (byte) (ticks - trialStart) >= SERIAL_TRIAL_TICKS) {
+		trialRunning = 0;
+		SetSerialBrg(trialBrg);
+		return true;
+	}
+	return false;
+}
+
+#endif
+
+#ifdef SERIAL_RS485
+
+void SetSerialAddress(byte address)
+{
+	ser_address = address;
+	rcsta.ADDEN = 1;
+}
+
+#endif
+
+#if defined(SERIAL_TX_QUEUE_LENGTH) && defined(SERIAL_RTSCTS)
+
+void UpdateSerial(void)
+{
+	// The interrupt stops while CTS is high, and nothing tells it when it drops.
+	if (txCount && SerialFlowClear())
+		pie1.TXIE = 1;
+}
+
+#endif
+
+#ifdef SERIAL_AUTOBAUD
+
+// Timer 1 overflows left before DetectSerialBaud() gives up.
+static byte autoBaudTimeout;
+
+// Returns false if the timeout has run out.
+static byte AutoBaudTimeLeft(void)
+{
+	if (pir1.TMR1IF) {
+		pir1.TMR1IF = 0;
+		if (!autoBaudTimeout)
+			return false;
+		--autoBaudTimeout;
+	}
+	return true;
+}
+
+#ifndef SERIAL_BAUDCTL
+
+// Waits for the receive pin to go to the given level.
+// Returns false if the timeout runs out first.
+static byte WaitForRx(byte level)
+{
+	while (SERIAL_RX_PIN != level) {
+		if (!AutoBaudTimeLeft())
+			return false;
+	}
+	return true;
+}
+
+#endif
+
+byte DetectSerialBaud(byte timeout)
+{
+	byte result = false;
+
+	// Keep the 'U' out of the input queue.
+	byte wasReceiving = pie1.RCIE;
+	pie1.RCIE = 0;
+
+	// Timer 1 counts instruction cycles, for the timeout and the measurement.
+	// Its interrupt would clear TMR1IF before the timeout saw it.
+	byte wasTimer1 = pie1.TMR1IE;
+	pie1.TMR1IE = 0;
+	t1con = 0;
+	tmr1h = 0;
+	tmr1l = 0;
+	pir1.TMR1IF = 0;
+	autoBaudTimeout = timeout;
+	t1con.TMR1ON = 1;
+
+#ifdef SERIAL_BAUDCTL
+
+	// The EUSART times the 'U' itself, and leaves the result in the baud rate generator.
+	SERIAL_BAUDCTL.ABDOVF = 0;
+	SERIAL_BAUDCTL.ABDEN = 1;
+	while (SERIAL_BAUDCTL.ABDEN && !SERIAL_BAUDCTL.ABDOVF) {
+		if (!AutoBaudTimeLeft())
+			break;
+	}
+
+	if (SERIAL_BAUDCTL.ABDEN || SERIAL_BAUDCTL.ABDOVF) {
+		// Failed; put back the old rate.
+		SERIAL_BAUDCTL.ABDEN = 0;
+		SERIAL_BAUDCTL.ABDOVF = 0;
+		LoadBrg(ser_brg);
+	} else {
+		MAKESHORT(ser_brg, spbrg, spbrgh);
+		result = true;
+	}
+
+	// It leaves a meaningless byte to clear RCIF.
+	rcreg;
+
+#else
+
+	// Time the 'U' by its rising edges.  The first data bit's and the stop bit's,
+	// with three more between, are 8 bits apart.
+	// Wait for the start bit with interrupts on, so a long wait doesn't cost uiTime its ticks;
+	// after that, one while waiting for an edge would make it late, so hold them off.
+	byte wasEnabled = rcsta.CREN;
+	rcsta.CREN = 0;
+	byte gie = intcon.GIE;
+
+	byte edge = 0;
+	if (WaitForRx(1) && WaitForRx(0)) {
+		intcon.GIE = 0;
+		while (WaitForRx(1)) {
+			if (edge == 0) {
+				// Start the measurement; from here, any overflow means it's too slow.
+				tmr1l = 0;
+				tmr1h = 0;
+				pir1.TMR1IF = 0;
+				autoBaudTimeout = 0;
+			}
+			if (++edge == 5 || !WaitForRx(0))
+				break;
+		}
+	}
+
+	if (edge == 5) {
+		t1con.TMR1ON = 0;
+		unsigned short cycles;
+		MAKESHORT(cycles, tmr1l, tmr1h);
+		t1con.TMR1ON = 1;
+
+		// Each bit is 16 (BRGH) times the rate from the generator, or 4 instruction cycles per count.
+		cycles = (cycles + 16) / 32;
+		if (cycles > 1 && cycles <= 256) {
+			LoadBrg(cycles - 1);
+			result = true;
+		}
+
+		// That was the stop bit, so the receiver won't start in the middle of the byte.
+	}
+
+	intcon.GIE = gie;
+	rcsta.CREN = wasEnabled;
+
+#endif
+
+	t1con.TMR1ON = 0;
+	pir1.TMR1IF = 0;
+	pie1.TMR1IE = wasTimer1;
+	pie1.RCIE = wasReceiving;
+
+	return result;
+}
+
+#endif
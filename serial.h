@@ -16,6 +16,64 @@
 */
 /*
 	Define SOFTWARE_RECEIVE to provide reception in software (not debugged or polished yet).
+
+	The bit rate is SERIAL_BAUD from serial-consts.h, or 9600 if that isn't defined,
+	and can be changed later with SetSerialBrg().
+
+	Define SERIAL_NEGOTIATE to switch to a faster rate for a bulk transfer, and back
+	if the other end doesn't follow.  Agree on it at the old rate, then call TrySerialBrg();
+	once something valid comes in at the new rate, call KeepSerialBrg().  If that hasn't
+	happened within SERIAL_TRIAL_TICKS (uiTime.h ticks, default 3 seconds), UpdateSerialBrg()
+	goes back to the old rate.  For example, with shell.h:
+
+		switch (UpdateShell()) {
+		case CMD_FAST:
+			WriteSerialString("OK\r\n");
+			TrySerialBrg(SERIAL_BRG(57600));  // waits for the "OK" to go out first
+			break;
+		case CMD_FAST_OK:
+			KeepSerialBrg();
+			break;
+		...
+		}
+		UpdateSerialBrg();
+
+	Define SERIAL_AUTOBAUD to get DetectSerialBaud(), which measures the rate from a 'U'
+	sent by the other end.
+
+	Define SERIAL_RTSCTS or SERIAL_XONXOFF for flow control.  When the input queue fills up
+	to SERIAL_FLOW_HIGH, the other end is told to stop, by raising RTS or sending an XOFF;
+	once ReadSerial() has brought it down to SERIAL_FLOW_LOW, it's told to go on.
+	In the other direction, sending waits while CTS is high, or after an XOFF until an XON,
+	and XON and XOFF aren't put in the queue.  Use TryWriteSerial() to keep from waiting.
+
+	Define SERIAL_TX_QUEUE_LENGTH (up to 127) to send through an output queue: WriteSerial()
+	adds to it and returns, and the interrupt (with TXIE) feeds the transmitter from it,
+	holding off while the other end has asked us to stop.  WriteSerial() only waits when
+	the queue is full, so a stream that's stopped can't hold up the main loop unless it
+	keeps writing; check SerialTxRoom() before a burst, or use TryWriteSerial(), to be sure.
+	The interrupt can't see CTS drop, so with SERIAL_RTSCTS, call UpdateSerial() often
+	from the main loop to start it sending again.
+
+	Define SERIAL_RS485 for a multi-drop bus, with 9-bit addressing: each frame starts with
+	an address byte, sent with the 9th bit set by WriteSerialAddress().  The EUSART (with ADDEN)
+	ignores everything until an address byte, and everything after one for another node,
+	so the interrupt only sees this node's frames.  The driver is enabled on SERIAL_DE_PORT
+	by the first WriteSerial(), and released by the interrupt as soon as the last stop bit is out.
+	There's no interrupt for that, so after the last byte the interrupt keeps coming back
+	(with TXIE) until it's gone, for up to a character's time.
+
+		InitializeSerial2(true, true);
+		SetSerialAddress(12);
+		...
+		while (1) {
+			if (ser_hasData)
+				...
+			if (reply) {
+				WriteSerialAddress(MASTER);
+				WriteSerialBuf(reply, len);
+			}
+		}
 */
 
 #ifndef __SERIAL_H
@@ -27,6 +85,28 @@
 #define SERIAL_EXTERN extern
 #endif
 
+#include "types-tjw.h"
+#include "uiTime.h"
+#include "profile.h"
+
+#include "serial-consts.h"
+
+// The EUSART's baud rate control register, on chips that have one.
+// With it, the baud rate generator is 16 bits, and can measure the bit rate itself.
+#if defined(_PIC16F688) || defined(_PIC16F690) || defined(_PIC16F883) || defined(_PIC16F886) || defined(_PIC18F1320)
+ #define SERIAL_BAUDCTL  baudctl
+#elif defined(_PIC18F2550) || defined(_PIC18F2620)
+ #define SERIAL_BAUDCTL  baudcon
+#endif
+
+// The baud rate generator setting for the given bit rate, at UITIME_FOSC.
+// Use it with a constant, so the division is done by the compiler.
+#ifdef SERIAL_BAUDCTL
+ #define SERIAL_BRG(baud)  ((UITIME_FOSC / 4 + (baud) / 2) / (baud) - 1)
+#else
+ #define SERIAL_BRG(baud)  ((UITIME_FOSC / 16 + (baud) / 2) / (baud) - 1)
+#endif
+
 // If this is set, there's a new byte to be read with ReadSerial().
 // (Internal: dataQueue is the next incoming byte.)
 // Cleared automatically by ReadSerial().
@@ -43,6 +123,22 @@ SERIAL_EXTERN bit ser_error;
 //   c: Collision, soft (the buffer in this module has overflowed)
 SERIAL_EXTERN char ser_errorType;
 
+// The baud rate generator's current setting.
+SERIAL_EXTERN unsigned short ser_brg;
+
+#ifdef SERIAL_XONXOFF
+// Set while the other end has sent an XOFF, and not yet an XON.
+SERIAL_EXTERN bit ser_paused;
+#endif
+
+#ifdef SERIAL_RS485
+// This node's address on the bus.
+SERIAL_EXTERN byte ser_address;
+
+// Set while this node has the bus driver enabled.
+SERIAL_EXTERN bit ser_transmitting;
+#endif
+
 // After calling this, set GIE to start processing.
 void InitializeSerial();  // equivalent to receive, no transmit, for legacy reasons.
 void InitializeSerial2(bool useReceive, bool useTransmit);
@@ -50,18 +146,189 @@ void InitializeSerial2(bool useReceive, bool useTransmit);
 // Must be called in an ISR.
 void SerialInterrupt();
 
+// Changes the bit rate, to a setting from SERIAL_BRG().
+// Waits until anything being sent has gone out completely, so it goes at the old rate.
+void SetSerialBrg(unsigned short brg);
+
+#ifdef SERIAL_NEGOTIATE
+
+// How long TrySerialBrg() waits for KeepSerialBrg(), in ticks.
+#ifndef SERIAL_TRIAL_TICKS
+ #define SERIAL_TRIAL_TICKS  (3 * TICKS_PER_SEC)
+#endif
+
+// Changes the bit rate as SetSerialBrg() does, keeping the current one to go back to.
+void TrySerialBrg(unsigned short brg);
+
+// Stays at the rate from TrySerialBrg(), since the other end has been heard from there.
+void KeepSerialBrg(void);
+
+// Call this often from the main loop while trying a rate.
+// Goes back to the old rate if it hasn't been kept within SERIAL_TRIAL_TICKS,
+// and returns true if it just did.
+byte UpdateSerialBrg(void);
+
+#endif
+
+#ifdef SERIAL_AUTOBAUD
+
+// Converts a time in ms to a timeout for DetectSerialBaud().
+#define SERIAL_AUTOBAUD_MS(ms)  (((ms) * UITIME_CYCLES_PER_MS + 65535) / 65536)
+
+// Waits for the other end to send a 'U', and sets the bit rate to match it.
+// Returns false if none came before the timeout, in units of 65536 instruction cycles (see above),
+// or if it was too slow to measure.
+// On chips with an EUSART, the EUSART measures it; otherwise it's timed from SERIAL_RX_PIN,
+// with interrupts masked from the start bit to the end of the 'U', about 10 bit times.
+// Either way, this borrows Timer 1, with its interrupt off, and leaves it stopped;
+// if uiTime or Sound use Timer 1, they need setting up again afterwards.
+byte DetectSerialBaud(byte timeout);
+
+#endif
+
+#ifdef SERIAL_RS485
+
+// Sets this node's address, and starts ignoring frames for other nodes.
+void SetSerialAddress(byte address);
+
+#endif
+
+#if defined(SERIAL_TX_QUEUE_LENGTH) && defined(SERIAL_RTSCTS)
+
+// Call this often from the main loop.  Restarts the output queue once CTS has dropped.
+void UpdateSerial(void);
+
+#endif
+
+#ifdef SERIAL_RS485
+
+// Enables the bus driver, if it isn't already.  Internal.
+// Call it with interrupts masked, since the interrupt releases the driver
+// once everything has gone out, and could do it between here and loading txreg.
+inline void SerialDriverOn(void)
+{
+	if (!ser_transmitting) {
+		set_bit(SERIAL_DE_PORT, SERIAL_DE_BIT);
+		ser_transmitting = 1;
+	}
+}
+
+#endif
+
 // Returns the next available character.
 // If this isn't called often enough, and incoming bytes collide, the Collision error is reported.
 unsigned char ReadSerial();
 
+// Returns false while the other end has asked us to stop.
+inline byte SerialFlowClear(void)
+{
+	#ifdef SERIAL_RTSCTS
+		if (test_bit(SERIAL_CTS_PORT, SERIAL_CTS_BIT))
+			return false;
+	#endif
+	#ifdef SERIAL_XONXOFF
+		if (ser_paused)
+			return false;
+	#endif
+	return true;
+}
+
+#ifdef SERIAL_TX_QUEUE_LENGTH
+
+// Returns the number of characters that can be written without waiting.
+byte SerialTxRoom(void);
+
+// Returns true if a character can be written right now: the output queue has room.
+inline byte SerialCanSend(void)
+{
+	return SerialTxRoom() != 0;
+}
+
+// Adds the specified character to the output queue, if SerialCanSend(), and returns true.
+// Otherwise returns false right away, so the caller can get on with something else.
+byte TryWriteSerial(char c);
+
+#else
+
+// Returns true if a character can be sent right now:
+// the transmitter has room, and the other end hasn't asked us to stop.
+inline byte SerialCanSend(void)
+{
+	return SerialFlowClear() && pir1.TXIF;
+}
+
+// Sends the specified character out the serial port, if SerialCanSend(), and returns true.
+// Otherwise returns false right away, so the caller can get on with something else.
+inline byte TryWriteSerial(char c)
+{
+	#if defined(SERIAL_XONXOFF) || defined(SERIAL_RS485)
+		// The interrupt may send an XON or XOFF, or release the bus, at any time,
+		// so check and send in one go.
+		byte gie;
+		PROFILE_GIE_SAVE(PROFILE_SERIAL_SEND, gie);
+	#endif
+
+	byte result = SerialCanSend();
+	if (result) {
+		#ifdef SERIAL_RS485
+			SerialDriverOn();
+		#endif
+		txreg = c;
+		#ifdef SERIAL_RS485
+			// So the interrupt releases the bus after it.
+			pie1.TXIE = 1;
+		#endif
+	}
+
+	#if defined(SERIAL_XONXOFF) || defined(SERIAL_RS485)
+		PROFILE_GIE_RESTORE(PROFILE_SERIAL_SEND, gie);
+	#endif
+	return result;
+}
+
+#endif
+
 // Sends the specified character out the serial port.
+// Waits until it can, including while the other end has asked us to stop;
+// with SERIAL_TX_QUEUE_LENGTH, that's only while the output queue is full.
 inline void WriteSerial(char c)
 {
+	while (!TryWriteSerial(c))
+		;
+}
+
+#ifdef SERIAL_RS485
+
+// Starts a frame for the node with the given address.
+inline void WriteSerialAddress(byte address)
+{
+	// The 9th bit goes along when txreg moves to the shift register,
+	// so it can only be set while nothing else is waiting to go.
+	#ifdef SERIAL_TX_QUEUE_LENGTH
+		while (SerialTxRoom() != SERIAL_TX_QUEUE_LENGTH)
+			;
+	#endif
+	while (!pir1.TXIF || !txsta.TRMT)
+		;
+	txsta.TX9D = 1;
+	#ifdef SERIAL_TX_QUEUE_LENGTH
+		// Straight to the transmitter, since the interrupt could be late taking it from the queue.
+		byte gie;
+		PROFILE_GIE_SAVE(PROFILE_SERIAL_SEND, gie);
+		SerialDriverOn();
+		txreg = address;
+		pie1.TXIE = 1;
+		PROFILE_GIE_RESTORE(PROFILE_SERIAL_SEND, gie);
+	#else
+		WriteSerial(address);
+	#endif
 	while (!pir1.TXIF)
 		;
-	txreg = c;
+	txsta.TX9D = 0;
 }
 
+#endif
+
 // Sends the specified null-terminated string out the serial port.
 inline void WriteSerialString(char* s)
 {
@@ -0,0 +1,271 @@
+/* serialPrintf.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <system.h>
+
+#include "serialPrintf.h"
+#include "serial.h"
+
+
+// Packed BCD of the number being printed, most significant digits first:
+// 10 digits, enough for any 32-bit value.
+#define BCD_BYTES  5
+static byte bcd[BCD_BYTES];
+
+
+// Converts the low 32 bits of val to decimal in bcd.
+// Returns the number of digits, not counting leading zeros, but at least 1.
+static byte ToBcd(unsigned long val)
+{
+	byte i, j;
+	for (j = 0; j < BCD_BYTES; ++j)
+		bcd[j] = 0;
+
+	// Leading zero bits don't change anything.
+	byte bits = 32;
+	while (bits && !(val & 0x80000000))  {
+		val <<= 1;
+		--bits;
+	}
+
+	for (i = 0; i < bits; ++i) {
+		// Add 3 to each digit of 5 or more, so the shift carries it into the next digit.
+		for (j = 0; j < BCD_BYTES; ++j) {
+			byte b = bcd[j];
+			if ((b & 0x0F) >= 0x05)
+				b += 0x03;
+			if (b >= 0x50)
+				b += 0x30;
+			bcd[j] = b;
+		}
+
+		// Shift the top bit of val in at the bottom.
+		byte carry = (val & 0x80000000) != 0;
+		val <<= 1;
+		j = BCD_BYTES;
+		while (j--) {
+			byte next = bcd[j] >> 7;
+			bcd[j] = (bcd[j] << 1) | carry;
+			carry = next;
+		}
+	}
+
+	// Count the digits.
+	byte digits = BCD_BYTES * 2;
+	for (j = 0; j < BCD_BYTES; ++j) {
+		if (bcd[j] & 0xF0)
+			break;
+		--digits;
+		if (bcd[j])
+			break;
+		--digits;
+	}
+	return digits ? digits : 1;
+}
+
+// Writes the last given number of digits in bcd.
+static void WriteBcd(byte digits)
+{
+	byte i = BCD_BYTES * 2 - digits;
+	while (digits--) {
+		byte b = bcd[i >> 1];
+		if (!(i & 1))
+			b >>= 4;
+		WriteSerial('0' + (b & 0x0F));
+		++i;
+	}
+}
+
+// Writes the given character the given number of times.
+static void WriteFill(char c, byte count)
+{
+	while (count--)
+		WriteSerial(c);
+}
+
+// Writes the fill for a field of the given width, with the sign (if any) where it belongs,
+// before a number of the given length.
+static void WritePadding(char fill, byte width, char sign, byte length)
+{
+	if (sign)
+		++length;
+
+	if (fill == '0' && sign) {
+		WriteSerial(sign);
+		sign = 0;
+	}
+	if (width > length)
+		WriteFill(fill, width - length);
+	if (sign)
+		WriteSerial(sign);
+}
+
+static void Printf(rom char* format, unsigned long val, byte isLong)
+{
+	byte pi = 0;
+	char c;
+	while ((c = format[pi++]) != 0) {
+		if (c != '%') {
+			WriteSerial(c);
+			continue;
+		}
+
+		c = format[pi++];
+		if (!c)
+			return;
+
+		char fill = ' ';
+		if (c == '0') {
+			fill = '0';
+			c = format[pi++];
+		}
+
+		byte width = 0;
+		if (c > '0' && c <= '9') {
+			width = c - '0';
+			c = format[pi++];
+		}
+
+		byte places = 2;
+		if (c == '.') {
+			places = format[pi++] - '0';
+			if (places > 4)
+				places = 4;
+			c = format[pi++];
+		}
+
+		if (c == 'l')
+			c = format[pi++];
+		if (!c)
+			return;
+
+		char sign = 0;
+		unsigned long n = val;
+		if (!isLong)
+			n &= 0xFFFF;
+
+		switch (c) {
+		case '%':
+		case 'c':
+			WriteSerial(c == '%' ? '%' : (char) val);
+			break;
+
+		case 'd':
+		case 'f':
+			// Make it 32 bits, with fixed16 as 16.16 like fixed32, and take the sign off.
+			if (!isLong) {
+				n = (signed long) (signed short) val;
+				if (c == 'f')
+					n <<= 8;
+			}
+			if (n & 0x80000000) {
+				sign = '-';
+				n = -n;
+			}
+
+			if (c == 'd') {
+				byte digits = ToBcd(n);
+				WritePadding(fill, width, sign, digits);
+				WriteBcd(digits);
+				break;
+			}
+
+			// Round to the places shown: add half of the last one, in 1/65536ths.
+			if (places == 0)
+				n += 32768;
+			else if (places == 1)
+				n += 3277;
+			else if (places == 2)
+				n += 328;
+			else if (places == 3)
+				n += 33;
+			else
+				n += 3;
+
+			{
+				unsigned short frac = n & 0xFFFF;
+				byte digits = ToBcd((n >> 16) & 0xFFFF);
+				WritePadding(fill, width, sign, places ? digits + 1 + places : digits);
+				WriteBcd(digits);
+
+				if (places)
+					WriteSerial('.');
+				while (places--) {
+					// frac * 10, as shifts and adds; the digit is what goes above 16 bits.
+					unsigned long ten = ((unsigned long) frac << 3) + ((unsigned long) frac << 1);
+					WriteSerial('0' + (byte) (ten >> 16));
+					frac = ten & 0xFFFF;
+				}
+			}
+			break;
+
+		case 'u':
+			{
+				byte digits = ToBcd(n);
+				WritePadding(fill, width, 0, digits);
+				WriteBcd(digits);
+			}
+			break;
+
+		case 'x':
+		case 'X':
+		case 'b':
+			{
+				// Digit number i is at bit i << shift.
+				byte shift = 2;
+				byte mask = 0x0F;
+				byte digits = isLong ? 8 : 4;
+				if (c == 'b') {
+					shift = 0;
+					mask = 0x01;
+					digits <<= 2;
+				}
+
+				// Count the digits, at least 1.
+				while (digits > 1 && !((n >> ((digits - 1) << shift)) & mask))
+					--digits;
+
+				WritePadding(fill, width, 0, digits);
+				while (digits--) {
+					byte d = (n >> (digits << shift)) & mask;
+					if (d > 9)
+						d += (c == 'X' ? 'A' : 'a') - 10;
+					else
+						d += '0';
+					WriteSerial(d);
+				}
+			}
+			break;
+
+		default:
+			// Not a format we know; show it as it was.
+			WriteSerial('%');
+			WriteSerial(c);
+			break;
+		}
+	}
+}
+
+void SerialPrintf(rom char* format, unsigned short val)
+{
+	Printf(format, val, false);
+}
+
+void SerialPrintfLong(rom char* format, unsigned long val)
+{
+	Printf(format, val, true);
+}
@@ -0,0 +1,68 @@
+/* serialPrintf.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Formatted output to the serial port, like LCD_Printf() in lcd.h: each character goes
+	straight to WriteSerial() as it's worked out, with no string built up in RAM.
+
+	Like LCD_Printf(), each call takes one value, used for every % in the format;
+	to print several values, make several calls.  Formats are ROM strings.
+
+		SerialPrintf("T=", 0);
+		SerialPrintf("%.1f C\r\n", temperature);  // a fixed16
+		SerialPrintf("ADC %4u  ", ReadAtoD());
+		SerialPrintf("flags %08b\r\n", flags);
+		SerialPrintfLong("up %lu s\r\n", seconds);
+
+	Each % is followed by:
+
+		0        optional; pad with zeros instead of spaces
+		1-9      optional; the minimum field width
+		.0-.4    optional; the number of decimal places, for f (default 2)
+		l        optional, and ignored; for readability with SerialPrintfLong()
+		d        signed decimal
+		u        unsigned decimal
+		x or X   hex, in lower or upper case
+		b        binary
+		f        fixed-point: fixed16 (fixed16.h) with SerialPrintf(),
+		         or fixed32 (fixed32.h) with SerialPrintfLong(); rounded to the places shown
+		c        the value as a character
+		%        a %
+
+	Decimal numbers are converted by shifting and adding (double dabble), and fractions
+	by multiplying by 10 as shifts and adds, so no division routine is pulled in.
+
+	Requires serial.h, set up for transmitting.  WriteSerial() waits while it can't send;
+	with SERIAL_TX_QUEUE_LENGTH, only while the output queue is full, so check SerialTxRoom()
+	first to keep from waiting on a stopped link.
+*/
+
+#ifndef __SERIAL_PRINTF_H
+#define __SERIAL_PRINTF_H
+
+
+#include "types-tjw.h"
+
+
+// Writes the format to the serial port, with the 16-bit value in place of each %.
+void SerialPrintf(rom char* format, unsigned short val);
+
+// Same, with a 32-bit value.
+void SerialPrintfLong(rom char* format, unsigned long val);
+
+
+#endif
@@ -18,6 +18,13 @@
 // Defines shadow registers for GPIO regs shared among multiple modules.
 // This lets one module change GPIO bits without affecting bits it doesn't control,
 // and without causing read-modify-write problems.
+//
+// These are safe to use from the main loop even if an ISR changes other bits
+// of the same shadow (as Sound does), without disabling interrupts:
+// - The shadow itself is only changed with a single read-modify-write instruction
+//   (bsf, bcf, or xorwf), which an interrupt can't split.
+// - The port is then written from the shadow, and written again if the shadow
+//   changed in between - i.e. if the ISR got in before the write and would otherwise be undone.
 
 #ifndef _TJW_SHADOWREGS_H
 #define _TJW_SHADOWREGS_H
@@ -34,23 +41,31 @@ SHADOW_REGS_EXTERN byte porta_;
 SHADOW_REGS_EXTERN byte portb_;
 SHADOW_REGS_EXTERN byte portc_;
 
+// Copies the shadow to its port, as above.
+#define WRITE_SHADOW(regName, shadowReg)  { byte shadowCopy_; do { shadowCopy_ = shadowReg; regName = shadowCopy_; } while (shadowCopy_ != shadowReg); }
+
 // Sets the specified shadowed register, changing only the masked bits.
-#define SET_SHADOW(regName, shadowReg, newValue, mask)  { shadowReg = (shadowReg & (~(mask))) | (newValue & mask); regName = shadowReg; }
-#define SET_SHADOW_A(newValue, mask)  { porta_ = (porta_ & (~(mask))) | (newValue & mask); porta = porta_; }
-#define SET_SHADOW_B(newValue, mask)  { portb_ = (portb_ & (~(mask))) | (newValue & mask); portb = portb_; }
-#define SET_SHADOW_C(newValue, mask)  { portc_ = (portc_ & (~(mask))) | (newValue & mask); portc = portc_; }
+// The xor only flips the masked bits that differ, so other bits are left alone even if they change meanwhile.
+#define SET_SHADOW(regName, shadowReg, newValue, mask)  { shadowReg ^= (shadowReg ^ (newValue)) & (mask); WRITE_SHADOW(regName, shadowReg); }
+#define SET_SHADOW_A(newValue, mask)  SET_SHADOW(porta, porta_, newValue, mask)
+#define SET_SHADOW_B(newValue, mask)  SET_SHADOW(portb, portb_, newValue, mask)
+#define SET_SHADOW_C(newValue, mask)  SET_SHADOW(portc, portc_, newValue, mask)
+
+// Sets the bits in setMask and clears those in clearMask, all in one port write.
+// Use this instead of a series of SET_SHADOW_BITs when several pins change together.
+#define SET_SHADOW_BITS(regName, shadowReg, setMask, clearMask)  SET_SHADOW(regName, shadowReg, setMask, (setMask) | (clearMask))
 	
 // Sets the given bit in a shadowed port.
 // The bit number must be constant.
 // NOTE: When newValue depends on shadowReg, BoostC seems to generate bad code!
-#define SET_SHADOW_BIT(regName, shadowReg, bit, newValue)  { shadowReg.bit = newValue; regName = shadowReg; }
-#define SET_SHADOW_A_BIT(bit, newValue)  { porta_.bit = newValue; porta = porta_; }
-#define SET_SHADOW_B_BIT(bit, newValue)  { portb_.bit = newValue; portb = portb_; }
-#define SET_SHADOW_C_BIT(bit, newValue)  { portc_.bit = newValue; portc = portc_; }
+#define SET_SHADOW_BIT(regName, shadowReg, bit, newValue)  { shadowReg.bit = newValue; WRITE_SHADOW(regName, shadowReg); }
+#define SET_SHADOW_A_BIT(bit, newValue)  SET_SHADOW_BIT(porta, porta_, bit, newValue)
+#define SET_SHADOW_B_BIT(bit, newValue)  SET_SHADOW_BIT(portb, portb_, bit, newValue)
+#define SET_SHADOW_C_BIT(bit, newValue)  SET_SHADOW_BIT(portc, portc_, bit, newValue)
 	
 // Toggles the given bit in a shadowed port.
 // The bit number must be constant.
-#define TOGGLE_SHADOW_BIT(regName, shadowReg, bit)  { shadowReg ^= (1 << bit); regName = shadowReg; }
+#define TOGGLE_SHADOW_BIT(regName, shadowReg, bit)  { shadowReg ^= (1 << bit); WRITE_SHADOW(regName, shadowReg); }
 
 #endif
 //_TJW_SHADOWREGS_H
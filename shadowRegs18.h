@@ -25,11 +25,18 @@
 
 #include "types-tjw.h"
 
+// Copies the shadow to its port - a no-op here, since the latch is the port.
+#define WRITE_SHADOW(regName, latchReg)
+
 // Sets the specified latch register, changing only the masked bits.
-#define SET_SHADOW(regName, latchReg, newValue, mask)  { latchReg = (latchReg & (~(mask))) | (newValue & mask);  }
-#define SET_SHADOW_A
-#define SET_SHADOW_B
-#define SET_SHADOW_C
+// This is a single xorwf on the latch, so it's safe even if an ISR changes other bits of the same port.
+#define SET_SHADOW(regName, latchReg, newValue, mask)  { latchReg ^= (latchReg ^ (newValue)) & (mask); }
+#define SET_SHADOW_A(newValue, mask)  SET_SHADOW(porta, lata, newValue, mask)
+#define SET_SHADOW_B(newValue, mask)  SET_SHADOW(portb, latb, newValue, mask)
+#define SET_SHADOW_C(newValue, mask)  SET_SHADOW(portc, latc, newValue, mask)
+
+// Sets the bits in setMask and clears those in clearMask, all in one latch write.
+#define SET_SHADOW_BITS(regName, latchReg, setMask, clearMask)  SET_SHADOW(regName, latchReg, setMask, (setMask) | (clearMask))
 	
 // Sets the given bit in a latched port.
 // The bit number must be constant.
@@ -0,0 +1,22 @@
+// shell-consts.h
+// Customize this to fit your application.
+
+
+#ifndef __SHELL_CONSTS
+#define __SHELL_CONSTS
+
+// The longest command line, not counting the line ending.  Max 254.
+#define SHELL_LINE_LENGTH  32
+
+// The most arguments any command takes.
+#define SHELL_MAX_ARGS  3
+
+// The most commands in the table.  Each one costs 2 bytes of RAM.
+#define SHELL_MAX_COMMANDS  8
+
+// The number of hash buckets the commands are sorted into; a power of 2.
+// About as many as there are commands keeps each lookup to one string comparison.
+#define SHELL_BUCKETS  8
+
+
+#endif
@@ -0,0 +1,305 @@
+/* shell.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_SHELL
+
+#include <system.h>
+
+#include "shell.h"
+#include "serial.h"
+
+
+// Ends the chains of commands in each bucket.
+#define NO_COMMAND  0xFF
+
+// The command table, and where each command's name starts in it.
+static rom char* shellTable;
+static byte cmdOffset[SHELL_MAX_COMMANDS];
+
+// The first command in each hash bucket, and the next one after each command.
+static byte bucketHead[SHELL_BUCKETS];
+static byte cmdNext[SHELL_MAX_COMMANDS];
+
+// The line being received, with room for a terminator.
+static char shellLine[SHELL_LINE_LENGTH + 1];
+static byte shellLen;
+static byte shellOverflow;
+
+
+// Adds a character to a hash.
+inline byte HashChar(byte hash, char c)
+{
+	// Rotate and mix; a couple of instructions on a PIC.
+	return ((hash << 1) | (hash >> 7)) ^ c;
+}
+
+// Returns true if c ends a command name in the table.
+inline byte IsNameEnd(char c)
+{
+	return c == ':' || c == '|' || c == 0;
+}
+
+void InitShell(rom char* commands)
+{
+	byte i;
+	for (i = 0; i < SHELL_BUCKETS; ++i)
+		bucketHead[i] = NO_COMMAND;
+
+	shellTable = commands;
+	shellLen = 0;
+	shellOverflow = false;
+
+	byte offset = 0;
+	byte command = 0;
+	while (commands[offset] && command < SHELL_MAX_COMMANDS) {
+		cmdOffset[command] = offset;
+
+		byte hash = 0;
+		while (!IsNameEnd(commands[offset]))
+			hash = HashChar(hash, commands[offset++]);
+
+		byte bucket = hash & (SHELL_BUCKETS - 1);
+		cmdNext[command] = bucketHead[bucket];
+		bucketHead[bucket] = command;
+		++command;
+
+		// Skip the argument letters, and the separator.
+		while (commands[offset] && commands[offset] != '|')
+			++offset;
+		if (commands[offset])
+			++offset;
+	}
+}
+
+byte ParseInt(char* s, signed short& value)
+{
+	byte negative = false;
+	if (*s == '-') {
+		negative = true;
+		++s;
+	}
+
+	unsigned short result = 0;
+	byte digits = 0;
+	if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+		s += 2;
+		while (*s) {
+			char c = *s++;
+			if (c >= '0' && c <= '9')
+				c -= '0';
+			else if (c >= 'a' && c <= 'f')
+				c -= 'a' - 10;
+			else if (c >= 'A' && c <= 'F')
+				c -= 'A' - 10;
+			else
+				return false;
+
+			if (result & 0xF000)
+				return false;
+			result = (result << 4) | c;
+			++digits;
+		}
+	} else {
+		while (*s) {
+			char c = *s++ - '0';
+			if (c > 9)
+				return false;
+
+			// Stop before it goes past 65535.
+			if (result > 6553 || (result == 6553 && c > 5))
+				return false;
+			result = result * 10 + c;
+			++digits;
+		}
+	}
+
+	if (!digits || (negative && result > 32768))
+		return false;
+
+	value = negative ? -result : result;
+	return true;
+}
+
+byte ParseFixed(char* s, fixed16& value)
+{
+	byte negative = false;
+	if (*s == '-') {
+		negative = true;
+		++s;
+	}
+
+	// The integral part.
+	byte integral = 0;
+	byte digits = 0;
+	while (*s && *s != '.') {
+		char c = *s++ - '0';
+		if (c > 9)
+			return false;
+		if (integral > 12 || (integral == 12 && c > 8))
+			return false;
+		integral = integral * 10 + c;
+		++digits;
+	}
+
+	// The fraction, in thousandths; more digits than that are ignored.
+	unsigned short thousandths = 0;
+	byte places = 0;
+	if (*s == '.') {
+		++s;
+		while (*s) {
+			char c = *s++ - '0';
+			if (c > 9)
+				return false;
+			if (places < 3) {
+				thousandths = thousandths * 10 + c;
+				++places;
+			}
+			++digits;
+		}
+	}
+	if (!digits)
+		return false;
+
+	while (places++ < 3)
+		thousandths *= 10;
+
+	// 256/1000 = 32/125, rounded.
+	unsigned short result = ((unsigned short) integral << 8) + (thousandths * 32 + 62) / 125;
+
+	// Stop before it wraps around; -128 fits, but 128 doesn't.
+	if (result > (negative ? 0x8000 : 0x7FFF))
+		return false;
+
+	value = negative ? -result : result;
+	return true;
+}
+
+// Returns true if the given word is the name of the command at the given offset in the table.
+static byte NameMatches(char* word, byte offset)
+{
+	while (!IsNameEnd(shellTable[offset])) {
+		if (*word++ != shellTable[offset++])
+			return false;
+	}
+	return *word == 0;
+}
+
+// Splits up the finished line, finds its command, and converts its arguments.
+static byte ParseLine(void)
+{
+	// Split the line into words in place, ending each with a null.
+	char* command = 0;
+	shellArgCount = 0;
+	byte hash = 0;
+	byte i = 0;
+	while (i < shellLen) {
+		// Skip spaces.
+		while (i < shellLen && (shellLine[i] == ' ' || shellLine[i] == '\t'))
+			shellLine[i++] = 0;
+		if (i == shellLen)
+			break;
+
+		char* word = &shellLine[i];
+		if (!command)
+			command = word;
+		else if (shellArgCount < SHELL_MAX_ARGS)
+			shellArgText[shellArgCount++] = word;
+		else
+			return SHELL_BAD_ARGS;
+
+		while (i < shellLen && shellLine[i] != ' ' && shellLine[i] != '\t') {
+			if (word == command)
+				hash = HashChar(hash, shellLine[i]);
+			++i;
+		}
+	}
+	shellLine[shellLen] = 0;
+
+	if (!command)
+		return SHELL_NONE;
+
+	// Look it up.
+	byte found = bucketHead[hash & (SHELL_BUCKETS - 1)];
+	while (found != NO_COMMAND && !NameMatches(command, cmdOffset[found]))
+		found = cmdNext[found];
+	if (found == NO_COMMAND)
+		return SHELL_UNKNOWN;
+
+	// Convert the arguments, as listed after the name.
+	byte offset = cmdOffset[found];
+	while (!IsNameEnd(shellTable[offset]))
+		++offset;
+	if (shellTable[offset] == ':')
+		++offset;
+
+	byte arg = 0;
+	char spec;
+	while ((spec = shellTable[offset]) != '|' && spec) {
+		if (arg == shellArgCount)
+			return SHELL_BAD_ARGS;
+
+		if (spec == 'n') {
+			if (!ParseInt(shellArgText[arg], shellArgs[arg]))
+				return SHELL_BAD_ARGS;
+		} else if (spec == 'f') {
+			if (!ParseFixed(shellArgText[arg], shellArgs[arg]))
+				return SHELL_BAD_ARGS;
+		}
+
+		++arg;
+		++offset;
+	}
+	if (arg != shellArgCount)
+		return SHELL_BAD_ARGS;
+
+	return found;
+}
+
+byte ShellInput(char c)
+{
+	if (c == '\r' || c == '\n') {
+		byte result;
+		if (shellOverflow)
+			result = SHELL_TOO_LONG;
+		else
+			result = ParseLine();
+
+		shellLen = 0;
+		shellOverflow = false;
+		return result;
+	}
+
+	if (c == 0x08 || c == 0x7F) {
+		if (shellLen)
+			--shellLen;
+	} else if (shellLen < SHELL_LINE_LENGTH)
+		shellLine[shellLen++] = c;
+	else
+		shellOverflow = true;
+
+	return SHELL_NONE;
+}
+
+byte UpdateShell(void)
+{
+	while (ser_hasData) {
+		byte result = ShellInput(ReadSerial());
+		if (result != SHELL_NONE)
+			return result;
+	}
+	return SHELL_NONE;
+}
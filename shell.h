@@ -0,0 +1,124 @@
+/* shell.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	A command shell for the serial port: collects lines of text, looks up the command,
+	and checks and converts its arguments, so the application only has to act on it.
+
+	The commands are listed in a ROM string, in the style of GetMenuChoice() in LCDUI.h:
+	each command's name, then a colon and a letter for each argument if it has any,
+	separated by vertical bars.  The argument letters are:
+
+		n - an integer, in decimal or with 0x in hex, from -32768 to 65535
+		f - a fixed16 number (fixed16.h), e.g. 12.5 or -0.25
+		s - any word
+
+	For example:
+
+		#define CMD_LED  0
+		#define CMD_SET  1
+		#define CMD_NAME  2
+		#define CMD_RESET  3
+		rom char* commands = "led:n|set:nf|name:s|reset";
+
+		...
+		InitShell(commands);
+		while (1) {
+			switch (UpdateShell()) {
+			case CMD_LED:
+				LED = shellArgs[0];
+				break;
+			case CMD_SET:
+				SetLevel(shellArgs[0], shellArgs[1]);
+				break;
+			case CMD_NAME:
+				SetName(shellArgText[0]);
+				break;
+			...
+			case SHELL_UNKNOWN:
+				WriteSerialString("?\r\n");
+				break;
+			}
+			...
+		}
+
+	The line is kept in a single buffer, and split into words in place,
+	so shellArgText points into it rather than at copies; it's good until the next call.
+
+	Commands are found by a hash of their names, worked out once by InitShell(),
+	so a lookup is one hash and usually one string comparison, however many commands there are.
+
+	Requires shell-consts.h, customized from shell-consts-template.h.
+	UpdateShell() reads from serial.h; call ShellInput() directly for other sources.
+*/
+
+#ifndef __SHELL_H
+#define __SHELL_H
+
+#ifdef IN_SHELL
+ #define SHELL_EXTERN
+#else
+ #define SHELL_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+#include "fixed16.h"
+
+#include "shell-consts.h"
+
+
+// Results from ShellInput() and UpdateShell(), other than command numbers.
+#define SHELL_NONE  0xFF  // no complete line yet, or it was blank
+#define SHELL_UNKNOWN  0xFE  // the command isn't in the table
+#define SHELL_BAD_ARGS  0xFD  // the wrong number of arguments, or one couldn't be converted
+#define SHELL_TOO_LONG  0xFC  // the line was longer than SHELL_LINE_LENGTH, and was thrown away
+
+
+// The number of arguments after the command.
+SHELL_EXTERN byte shellArgCount;
+
+// The converted value of each n or f argument; fixed16 for f.
+SHELL_EXTERN signed short shellArgs[SHELL_MAX_ARGS];
+
+// The text of each argument, null-terminated, in the line buffer.
+SHELL_EXTERN char* shellArgText[SHELL_MAX_ARGS];
+
+
+// Call this once, with the table of commands described above.
+void InitShell(rom char* commands);
+
+// Adds the given received character to the line.
+// Returns the command's number (its position in the table, from 0) when a line is finished,
+// one of the errors above, or SHELL_NONE.
+// A line ends with a CR or LF, and backspace removes the last character.
+byte ShellInput(char c);
+
+// Reads everything that's come in from the serial port, and returns as ShellInput() does
+// as soon as a line is finished.
+byte UpdateShell(void);
+
+// Converts the given text to an integer, as for an n argument.
+// Returns false if it isn't one.
+byte ParseInt(char* s, signed short& value);
+
+// Converts the given text to fixed-point, as for an f argument.
+// Returns false if it isn't a number, or it's out of the range of a fixed16.
+byte ParseFixed(char* s, fixed16& value);
+
+
+#endif
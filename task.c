@@ -0,0 +1,35 @@
+/* task.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_TASK
+
+#include <system.h>
+
+#include "task.h"
+
+
+unsigned short TaskNowMs(void)
+{
+	// The ISR may bump the count between reading its two bytes.
+	// Two reads in a row that agree can't have been torn, since it only changes once a ms.
+	unsigned short result;
+	do
+		result = taskMs;
+	while (result != taskMs);
+
+	return result;
+}
@@ -0,0 +1,169 @@
+/* task.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Lightweight cooperative tasks, in the style of protothreads.
+
+	A task is an ordinary function that takes a Task* and returns TASK_RUNNING or TASK_DONE.
+	When it needs to wait - for some time to pass, for an event, or for a condition -
+	it returns to its caller, and picks up where it left off the next time it's called.
+	Tasks are stackless: a waiting task costs one return, not a hardware stack level,
+	and only the few bytes in its Task structure.
+
+	There's no dispatcher; the main loop is the scheduler, and just calls each task in turn:
+
+		Task blinkTask;
+
+		byte BlinkTask(Task* t)
+		{
+			TASK_BEGIN(t);
+			while (1) {
+				LED = 1;
+				TASK_SLEEP_MS(t, 100);
+				LED = 0;
+				TASK_WAIT_EVENT(t, EVENT_BUTTON);
+			}
+			TASK_END(t);
+		}
+
+		void interrupt(void)
+		{
+			byte ms = UiTimeInterrupt();
+			while (ms--)
+				UpdateTasksMs();
+		}
+
+		void main(void)
+		{
+			InitTask(&blinkTask);
+			...
+			while (1) {
+				BlinkTask(&blinkTask);
+				...
+			}
+		}
+
+	Rules for writing tasks:
+
+	- Local variables are NOT preserved across waits.  Keep state in statics,
+		globals, or the Task's own scratch field.
+
+	- Don't wait from inside a switch statement in the task function,
+		since the waits are themselves implemented as case labels.
+		For the same reason, put at most one wait on each source line.
+
+	- A task can run another task to completion with TASK_WAIT_TASK.
+
+	Several modules offer *Task versions of their blocking calls, built on this.
+*/
+
+#ifndef __TASK_H
+#define __TASK_H
+
+#ifdef IN_TASK
+ #define TASK_EXTERN
+#else
+ #define TASK_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+
+// Return values from task functions.
+#define TASK_RUNNING  0
+#define TASK_DONE  1
+
+
+typedef struct {
+	unsigned short resume;  // where to pick up again; 0 = the beginning
+	unsigned short wakeMs;  // for TASK_SLEEP_MS
+	byte i;  // scratch, e.g. for a loop counter that has to survive waits
+} Task;
+
+
+// Milliseconds since startup, maintained by UpdateTasksMs().
+// Rolls over every 65 seconds; read it with TaskNowMs().
+TASK_EXTERN volatile unsigned short taskMs;
+
+// Event flags, one per bit, for TASK_WAIT_EVENT.
+// The meanings are up to the application.
+// Set them with SignalTaskEvent(), from the main loop or from an ISR.
+TASK_EXTERN byte taskEvents;
+
+
+// Call this once per millisecond, usually from the interrupt handler.
+inline void UpdateTasksMs(void)
+{
+	++taskMs;
+}
+
+// Returns taskMs, safely read from outside the ISR.
+unsigned short TaskNowMs(void);
+
+// Returns true if the given time, in taskMs terms, has arrived.
+// Works across rollover, for times up to 32 seconds away.
+inline byte TaskTimeReached(unsigned short when)
+{
+	return (signed short)(TaskNowMs() - when) >= 0;
+}
+
+// Sets the given event bit(s).
+// Use a constant mask, so this is a single instruction and safe from an ISR.
+#define SignalTaskEvent(mask)  (taskEvents |= (mask))
+
+// Sets the task back to its beginning.
+// Call this before first running a task, or to abandon what it's doing.
+inline void InitTask(Task* t)
+{
+	t->resume = 0;
+}
+
+
+// Running into a resume point is deliberate; this says so, for compilers that warn about it
+// (e.g. GCC's -Wimplicit-fallthrough in the host build).  Comments are gone from inside a macro.
+#ifdef __GNUC__
+ #define TASK_FALLTHROUGH  __attribute__((fallthrough));
+#else
+ #define TASK_FALLTHROUGH
+#endif
+
+// These bracket the body of every task function.
+#define TASK_BEGIN(t)  switch ((t)->resume) { case 0:
+#define TASK_END(t)  } (t)->resume = 0; return TASK_DONE;
+
+// Waits until the given condition is true.
+#define TASK_WAIT_UNTIL(t, cond)  (t)->resume = __LINE__; TASK_FALLTHROUGH case __LINE__: if (!(cond)) return TASK_RUNNING;
+
+// Gives other tasks a turn, once.
+#define TASK_YIELD(t)  (t)->resume = __LINE__; return TASK_RUNNING; case __LINE__:
+
+// Waits for at least the given number of milliseconds (up to 32767).
+#define TASK_SLEEP_MS(t, ms)  (t)->wakeMs = TaskNowMs() + (ms); TASK_WAIT_UNTIL(t, TaskTimeReached((t)->wakeMs))
+
+// Waits until any of the given event bits is set, then clears them.
+#define TASK_WAIT_EVENT(t, mask)  TASK_WAIT_UNTIL(t, taskEvents & (mask)); taskEvents &= ~(mask);
+
+// Runs another task until it's done.
+// The child needs its own Task structure; call is the full call to the child's function.
+#define TASK_WAIT_TASK(t, child, call)  InitTask(child); TASK_WAIT_UNTIL(t, (call) != TASK_RUNNING)
+
+// Ends the task early.
+#define TASK_EXIT(t)  (t)->resume = 0; return TASK_DONE;
+
+
+#endif
@@ -0,0 +1,20 @@
+// telemetry-consts.h
+// Customize this to fit your application.
+
+
+#ifndef __TELEMETRY_CONSTS
+#define __TELEMETRY_CONSTS
+
+// The number of values sent in each frame.  Each one costs 2 bytes of RAM.
+#define TELEMETRY_CHANNELS  3
+
+// Every this many frames is a keyframe, which a receiver can start decoding from.
+// Max 255.
+#define TELEMETRY_KEY_INTERVAL  32
+
+// Define this to end each frame with a CRC-8 (crc_8bit.h), so a receiver can tell
+// if one was garbled.  Costs a byte per frame.
+//#define TELEMETRY_CRC
+
+
+#endif
@@ -0,0 +1,138 @@
+/* telemetry.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_TELEMETRY
+
+#include <system.h>
+
+#include "telemetry.h"
+#include "serial.h"
+#ifdef TELEMETRY_CRC
+ #include "crc_8bit.h"
+#endif
+
+
+// The values in the last frame, which the next one's changes are from.
+static unsigned short lastSent[TELEMETRY_CHANNELS];
+
+// Counts frames, for the header.
+static byte sequence;
+
+// Frames left before the next keyframe.
+static byte untilKey;
+
+#ifdef SERIAL_TX_QUEUE_LENGTH
+	// The most a frame can take: a header, up to 3 bytes per channel and a CRC,
+	// all possibly escaped, between two ENDs.
+	#ifdef TELEMETRY_CRC
+		#define MAX_FRAME  (2 * (1 + 3 * TELEMETRY_CHANNELS + 1) + 2)
+	#else
+		#define MAX_FRAME  (2 * (1 + 3 * TELEMETRY_CHANNELS) + 2)
+	#endif
+	#if MAX_FRAME > SERIAL_TX_QUEUE_LENGTH
+		#error "telemetry.c - a frame may not fit in SERIAL_TX_QUEUE_LENGTH"
+	#endif
+#endif
+
+
+void InitTelemetry(void)
+{
+	sequence = 0;
+	untilKey = 0;
+}
+
+void TelemetryKeyframe(void)
+{
+	untilKey = 0;
+}
+
+// Sends a byte of a frame, escaping it if it's one of the framing bytes.
+static void SendEscaped(byte b)
+{
+	if (b == TELEMETRY_END) {
+		WriteSerial(TELEMETRY_ESC);
+		b = TELEMETRY_ESC_END;
+	} else if (b == TELEMETRY_ESC) {
+		WriteSerial(TELEMETRY_ESC);
+		b = TELEMETRY_ESC_ESC;
+	}
+	WriteSerial(b);
+}
+
+// Sends a byte of a frame, and adds it to the CRC.
+inline void SendByte(byte b)
+{
+	#ifdef TELEMETRY_CRC
+		crc8(b);
+	#endif
+	SendEscaped(b);
+}
+
+byte SendTelemetry(void)
+{
+	#ifdef SERIAL_TX_QUEUE_LENGTH
+		// Skip the frame rather than wait, e.g. while the other end has sent an XOFF;
+		// the next one is sent as changes from the last one that went.
+		if (SerialTxRoom() < MAX_FRAME)
+			return false;
+	#endif
+
+	byte header = sequence++ & 0x7F;
+	if (!untilKey) {
+		header |= TELEMETRY_KEY;
+		untilKey = TELEMETRY_KEY_INTERVAL;
+
+		// An END first, so a receiver that's just started listening takes the keyframe
+		// as a whole frame, rather than throwing it away as the tail of one it missed.
+		WriteSerial(TELEMETRY_END);
+	}
+	--untilKey;
+
+	#ifdef TELEMETRY_CRC
+		crc8Init();
+	#endif
+	SendByte(header);
+
+	byte i;
+	for (i = 0; i < TELEMETRY_CHANNELS; ++i) {
+		unsigned short value = telemetryValues[i];
+		signed short change = value;
+		if (!(header & TELEMETRY_KEY))
+			change -= lastSent[i];
+		lastSent[i] = value;
+
+		// Zig-zag: move the sign to bit 0, so small changes either way have no high bits.
+		unsigned short zigzag = change << 1;
+		if (change < 0)
+			zigzag = ~zigzag;
+
+		// Varint: 7 bits at a time, low first, with the top bit set if there's more.
+		while (zigzag >= 0x80) {
+			byte b;
+			LOBYTE(b, zigzag);
+			SendByte(b | 0x80);
+			zigzag >>= 7;
+		}
+		SendByte(zigzag);
+	}
+
+	#ifdef TELEMETRY_CRC
+		SendEscaped(crc);
+	#endif
+	WriteSerial(TELEMETRY_END);
+	return true;
+}
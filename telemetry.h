@@ -0,0 +1,106 @@
+/* telemetry.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Sends a stream of readings from several channels over the serial port, compactly enough
+	for a slow link: each value is sent as its change from the last one sent on that channel.
+
+	Set telemetryValues, then call SendTelemetry() to send them all as a frame.
+	Each change is zig-zag encoded (0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...),
+	then sent as a varint: 7 bits per byte, low bits first, with the top bit set on every byte
+	but the last.  So a change of -64 to 63 takes one byte, and -8192 to 8191 takes two.
+
+	Every TELEMETRY_KEY_INTERVAL frames, and after TelemetryKeyframe(), the frame is a keyframe,
+	whose values are sent as changes from 0, so a receiver that's just started listening,
+	or missed a frame, can pick up from there.
+
+	Frames are SLIP-framed: each one ends with 0xC0, and any 0xC0 or 0xDB in it is sent
+	as 0xDB 0xDC or 0xDB 0xDD.  Keyframes also start with 0xC0, so the first one from power-up
+	is whole to a receiver that was already listening.  Inside that, a frame is:
+
+		header - bit 7 set for a keyframe; bits 0-6 count frames, so a receiver can tell one was lost
+		a varint for each channel
+		CRC-8 of the header and varints, if TELEMETRY_CRC is defined
+
+	For slowly-changing readings like temperatures, ADC and CapSense values,
+	a frame of 3 channels is usually 5 bytes, where "1234,567,8901\r\n" would be 15.
+
+	host/telemetryDecode.cpp decodes the stream on a PC.
+
+	Sample code:
+
+		InitializeSerial2(false, true);
+		InitTelemetry();
+		while (1) {
+			if (sampleDue) {
+				telemetryValues[0] = temperature;
+				telemetryValues[1] = ReadAtoD();
+				telemetryValues[2] = capSenseReading;
+				SendTelemetry();
+			}
+			...
+		}
+
+	Values are unsigned shorts, but signed ones work just as well; the differences are the same.
+
+	Requires telemetry-consts.h, customized from telemetry-consts-template.h.
+	Sends with WriteSerial(), from serial.h; with its SERIAL_TX_QUEUE_LENGTH, a frame is
+	queued whole or not at all, so a stopped link drops frames rather than holding up the caller.
+*/
+
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#ifdef IN_TELEMETRY
+ #define TELEMETRY_EXTERN
+#else
+ #define TELEMETRY_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+#include "telemetry-consts.h"
+
+
+// SLIP framing bytes.
+#define TELEMETRY_END  0xC0
+#define TELEMETRY_ESC  0xDB
+#define TELEMETRY_ESC_END  0xDC
+#define TELEMETRY_ESC_ESC  0xDD
+
+// Set in a keyframe's header.
+#define TELEMETRY_KEY  0x80
+
+
+// The values to send in the next frame.
+TELEMETRY_EXTERN unsigned short telemetryValues[TELEMETRY_CHANNELS];
+
+
+// Call this once before sending.  The first frame will be a keyframe.
+void InitTelemetry(void);
+
+// Sends telemetryValues as a frame, and returns true.
+// With SERIAL_TX_QUEUE_LENGTH, returns false instead of waiting if the frame might not fit
+// in the output queue, and sends nothing.
+byte SendTelemetry(void);
+
+// Makes the next frame a keyframe, e.g. when a receiver has just connected.
+void TelemetryKeyframe(void);
+
+
+#endif
@@ -0,0 +1,118 @@
+/* timeDiscipline.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define IN_TIME_DISCIPLINE
+
+#include <system.h>
+#include <stdlib.h>
+
+#include "timeDiscipline.h"
+
+
+#ifndef UITIME_TRIM
+ #error "timeDiscipline.c - define UITIME_TRIM in the project"
+#endif
+
+// ticks and tickScaler together count ms, rolling over at this.
+#define MS_PER_TICKS_ROLLOVER  (256L * MS_PER_TICK)
+
+#define WINDOW_MS  (DISCIPLINE_WINDOW_SECONDS * 1000)
+
+// Windows that are off by more than this are assumed to have missed or gained an edge,
+// and are ignored.  (1/16 is over 6%.)
+#define MAX_ERROR_MS  (WINDOW_MS / 16)
+
+// An error of e ms is a fraction e / WINDOW_MS, and uiTrim is in 1/256ths of a cycle
+// per UITIME_CYCLES_PER_INT (256 * UITIME_T0_PRESCALE) cycles, so the whole correction
+// is e * 65536 * UITIME_T0_PRESCALE / WINDOW_MS uiTrim units.
+// Half of that, divided before multiplying by the prescale, stays within a signed long
+// for any window and prescale: e is at most MAX_ERROR_MS, so e * 32768 is under 2^29.
+// The trim itself stops a carried fraction (up to 255) short of 0x7FFF, so
+// UiTimeTrimCycles() can add them without overflowing.
+#define MAX_TRIM  0x7F00
+
+
+// The ms count at the start of the current window.
+static unsigned short windowStartMs;
+
+// RTC edges seen in the current window; 0 means the window hasn't started.
+static byte windowSeconds;
+
+// Set by the ISR when disciplineErrorMs has a new value.
+static bit newError;
+
+
+// Returns the current ms count, from 0 up to MS_PER_TICKS_ROLLOVER.
+inline unsigned short UiMsCount(void)
+{
+	return (unsigned short) ticks * MS_PER_TICK + tickScaler;
+}
+
+void InitDiscipline(void)
+{
+	windowSeconds = 0;
+	newError = 0;
+	disciplineErrorMs = 0;
+}
+
+void DisciplineRtcSecond(void)
+{
+	unsigned short now = UiMsCount();
+	
+	if (windowSeconds && ++windowSeconds > DISCIPLINE_WINDOW_SECONDS) {
+		unsigned short elapsed = now - windowStartMs;
+		if (now < windowStartMs)
+			elapsed += MS_PER_TICKS_ROLLOVER;
+		
+		disciplineErrorMs = elapsed - WINDOW_MS;
+		newError = 1;
+		
+		// This edge also starts the next window.
+		windowSeconds = 0;
+	}
+	
+	if (!windowSeconds) {
+		windowStartMs = now;
+		windowSeconds = 1;
+	}
+}
+
+void UpdateDiscipline(void)
+{
+	if (!newError)
+		return;
+	newError = 0;
+	
+	signed short error = disciplineErrorMs;
+	if (abs(error) > MAX_ERROR_MS)
+		return;
+	
+	// Take out half the measured error each window.
+	// That settles quickly, without chasing the +/- 1 ms jitter in each measurement.
+	signed long correction = (signed long) error * 32768L / WINDOW_MS * UITIME_T0_PRESCALE;
+	
+	// Past the range of uiTrim, the best it can do is its limit.
+	signed long trim = uiTrim - correction;
+	if (trim > MAX_TRIM)
+		trim = MAX_TRIM;
+	else if (trim < -MAX_TRIM)
+		trim = -MAX_TRIM;
+	
+	intcon.GIE = 0;
+	uiTrim = (signed short) trim;
+	intcon.GIE = 1;
+}
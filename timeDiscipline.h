@@ -0,0 +1,92 @@
+/* timeDiscipline.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Disciplines uiTime's Timer 0 timebase against the DS1307's crystal.
+
+	Counts uiTime's ms between the RTC's 1 Hz square-wave edges, over a window of
+	DISCIPLINE_WINDOW_SECONDS, and nudges uiTrim to take out the difference.
+	After a few windows, ticks, uiSeconds, and dayTime run at the crystal's rate,
+	even between RTC reads and with an internal RC oscillator - and without any more I2C traffic.
+
+	Requires:
+		uiTime, driven by Timer 0, with UITIME_TRIM defined in the project.
+		DallasClock's SQW/OUT pin wired to an interrupt, as for InitDallasClockSqw().
+
+	Sample code:
+
+		void interrupt(void)
+		{
+			UiTimeInterrupt();
+
+			if (<the SQW edge interrupt flag>) {
+				<clear it>
+				ClockSecondInterrupt();
+				DisciplineRtcSecond();
+			}
+		}
+
+		...
+		InitDallasClockSqw();
+		InitDiscipline();
+		while (1) {
+			UpdateDallasClock();
+			UpdateDiscipline();
+			...
+		}
+*/
+
+#ifndef __TIME_DISCIPLINE_H
+#define __TIME_DISCIPLINE_H
+
+#ifdef IN_TIME_DISCIPLINE
+ #define TIME_DISCIPLINE_EXTERN
+#else
+ #define TIME_DISCIPLINE_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+#include "uiTime.h"
+
+
+// RTC seconds per measurement.
+// Longer windows measure more finely (each ms of error is 1000 / this ppm),
+// but must stay under the 64 seconds it takes ticks to roll over.
+#ifndef DISCIPLINE_WINDOW_SECONDS
+ #define DISCIPLINE_WINDOW_SECONDS  32
+#endif
+
+
+// The error measured over the last window: internal ms counted, less real ms.
+// Positive means the internal timebase was running fast.
+TIME_DISCIPLINE_EXTERN signed short disciplineErrorMs;
+
+
+// Call this once to start.
+// If you've saved uiTrim from an earlier run (e.g. in EEPROM), restore it first.
+void InitDiscipline(void);
+
+// Call this from the ISR on each falling edge of the RTC's square wave.
+void DisciplineRtcSecond(void);
+
+// Call this from the main loop.
+// Applies the correction from each window as it finishes.
+void UpdateDiscipline(void);
+
+
+#endif
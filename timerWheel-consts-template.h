@@ -0,0 +1,20 @@
+// timerWheel-consts.h
+// Customize this to fit your application.
+
+
+#ifndef __TIMER_WHEEL_CONSTS
+#define __TIMER_WHEEL_CONSTS
+
+// The timer IDs, sequential from 0.
+// Replace these with the timers needed for your app.
+// These are also the values returned by GetExpiredTimer().
+#define BLINK_TIMER  0
+#define DEBOUNCE_TIMER  1
+#define BACKLIGHT_TIMER  2
+
+// The number of timers - one more than the last ID.
+// Each one costs 9 bytes of RAM.  Max 254.
+#define NUM_TIMERS  3
+
+
+#endif
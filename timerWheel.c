@@ -0,0 +1,235 @@
+/* timerWheel.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <system.h>
+#include <memory.h>
+
+#define IN_TIMER_WHEEL
+#include "timerWheel.h"
+
+
+// Each level has 16 slots; slot numbers run through all levels,
+// so level 1 starts at slot 16 and level 2 at slot 32.
+#define WHEEL_SLOTS  16
+#define WHEEL_LEVELS  3
+#define LEVEL1  WHEEL_SLOTS
+#define LEVEL2  (2 * WHEEL_SLOTS)
+
+// Stored in timerSlot when a timer isn't in the wheel.
+#define NO_SLOT  0xFF
+
+// Values for timerPending.
+#define NOT_PENDING  0
+#define PENDING  1
+#define PENDING_STOPPED  2  // still in the ready queue, but should be skipped
+
+
+// The first timer in each slot, or NO_TIMER.
+static byte wheelHeads[WHEEL_LEVELS * WHEEL_SLOTS];
+
+// Per-timer state.
+// Each slot is a doubly-linked list, so a timer can be removed without searching.
+static unsigned short timerExpiry[NUM_TIMERS];  // in wheelNow's terms
+static unsigned short timerPeriod[NUM_TIMERS];  // 0 for one-shot
+static byte timerNext[NUM_TIMERS];
+static byte timerPrev[NUM_TIMERS];
+static byte timerSlot[NUM_TIMERS];  // or NO_SLOT
+static byte timerPending[NUM_TIMERS];
+
+// The ready queue: IDs of expired timers, in order.
+// Each timer is in here at most once (timerPending guards that), so NUM_TIMERS entries is enough.
+static byte readyTimers[NUM_TIMERS];
+static byte readyHead;
+static byte readyCount;
+
+
+// Adds the given timer to the front of the given slot's list.
+static void LinkTimer(byte id, byte slot)
+{
+	byte next = wheelHeads[slot];
+	timerNext[id] = next;
+	timerPrev[id] = NO_TIMER;
+	if (next != NO_TIMER)
+		timerPrev[next] = id;
+	wheelHeads[slot] = id;
+	timerSlot[id] = slot;
+}
+
+// Removes the given timer from whatever slot it's in, if any.
+static void UnlinkTimer(byte id)
+{
+	byte slot = timerSlot[id];
+	if (slot == NO_SLOT)
+		return;
+
+	byte next = timerNext[id];
+	byte prev = timerPrev[id];
+	if (prev == NO_TIMER)
+		wheelHeads[slot] = next;
+	else
+		timerNext[prev] = next;
+	if (next != NO_TIMER)
+		timerPrev[next] = prev;
+
+	timerSlot[id] = NO_SLOT;
+}
+
+// Puts the given timer in the slot that will come around when it expires,
+// or as close as the wheel can get if that's too far away.
+static void FileTimer(byte id)
+{
+	unsigned short expiry = timerExpiry[id];
+	unsigned short delta = expiry - wheelNow;
+	byte slot;
+
+	if (delta < 16)
+		slot = expiry & 0x0F;
+	else if (delta < 256)
+		slot = LEVEL1 + ((expiry >> 4) & 0x0F);
+	else if (delta < 4096)
+		slot = LEVEL2 + ((expiry >> 8) & 0x0F);
+	else
+		// Park it in the top-level slot that comes around last; it'll be re-filed from there.
+		slot = LEVEL2 + (((wheelNow >> 8) - 1) & 0x0F);
+
+	LinkTimer(id, slot);
+}
+
+// Re-files every timer in the given slot into the lower levels.
+static void CascadeSlot(byte slot)
+{
+	byte id = wheelHeads[slot];
+	wheelHeads[slot] = NO_TIMER;
+
+	while (id != NO_TIMER) {
+		byte next = timerNext[id];
+		FileTimer(id);
+		id = next;
+	}
+}
+
+// Puts the given timer on the ready queue, unless it's already there.
+static void MarkTimerReady(byte id)
+{
+	if (timerPending[id] == NOT_PENDING) {
+		byte i = readyHead + readyCount;
+		if (i >= NUM_TIMERS)
+			i -= NUM_TIMERS;
+		readyTimers[i] = id;
+		++readyCount;
+	}
+
+	// If it was stopped while waiting, it reuses its old place in line.
+	timerPending[id] = PENDING;
+}
+
+void InitTimerWheel(void)
+{
+	memset(wheelHeads, NO_TIMER, sizeof(wheelHeads));
+	memset(timerSlot, NO_SLOT, sizeof(timerSlot));
+	memset(timerPending, NOT_PENDING, sizeof(timerPending));
+	readyHead = 0;
+	readyCount = 0;
+	wheelNow = 0;
+}
+
+void TimerWheelTick(void)
+{
+	++wheelNow;
+
+	// Bring down the higher levels, top first, as their slots come around.
+	if ((wheelNow & 0xFF) == 0)
+		CascadeSlot(LEVEL2 + ((wheelNow >> 8) & 0x0F));
+	if ((wheelNow & 0x0F) == 0)
+		CascadeSlot(LEVEL1 + ((wheelNow >> 4) & 0x0F));
+
+	// Everything left in the current level-0 slot is due now.
+	byte slot = wheelNow & 0x0F;
+	byte id = wheelHeads[slot];
+	wheelHeads[slot] = NO_TIMER;
+
+	while (id != NO_TIMER) {
+		byte next = timerNext[id];
+		timerSlot[id] = NO_SLOT;
+
+		// Reschedule from the expiry time, not from now, so periodic timers don't drift.
+		if (timerPeriod[id]) {
+			timerExpiry[id] += timerPeriod[id];
+			FileTimer(id);
+		}
+
+		MarkTimerReady(id);
+		id = next;
+	}
+}
+
+void StartTimer(byte id, unsigned short delay, unsigned short period)
+{
+	if (delay == 0)
+		delay = 1;
+
+	intcon.GIE = 0;
+
+	UnlinkTimer(id);
+	if (timerPending[id] == PENDING)
+		timerPending[id] = PENDING_STOPPED;
+
+	timerExpiry[id] = wheelNow + delay;
+	timerPeriod[id] = period;
+	FileTimer(id);
+
+	intcon.GIE = 1;
+}
+
+void StopTimer(byte id)
+{
+	intcon.GIE = 0;
+
+	UnlinkTimer(id);
+	if (timerPending[id] == PENDING)
+		timerPending[id] = PENDING_STOPPED;
+
+	intcon.GIE = 1;
+}
+
+byte IsTimerActive(byte id)
+{
+	return timerSlot[id] != NO_SLOT || timerPending[id] == PENDING;
+}
+
+byte GetExpiredTimer(void)
+{
+	byte result = NO_TIMER;
+
+	intcon.GIE = 0;
+
+	while (readyCount && result == NO_TIMER) {
+		byte id = readyTimers[readyHead];
+		if (++readyHead >= NUM_TIMERS)
+			readyHead = 0;
+		--readyCount;
+
+		// Skip over timers that were stopped after they expired.
+		if (timerPending[id] == PENDING)
+			result = id;
+		timerPending[id] = NOT_PENDING;
+	}
+
+	intcon.GIE = 1;
+
+	return result;
+}
@@ -0,0 +1,112 @@
+/* timerWheel.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Software timers, driven by the millisecond tick from uiTime.
+
+	Any number of one-shot and periodic timers (up to NUM_TIMERS, from timerWheel-consts.h)
+	can be running at once.  Starting, stopping, and expiring a timer are all constant-time,
+	no matter how many timers are running or how long their delays are.
+
+	Timers are kept in a hierarchical "timing wheel": three levels of 16 slots each,
+	covering 16 ms, 256 ms, and 4096 ms.  Each tick only looks at one level-0 slot;
+	every 16th tick, one level-1 slot is redistributed into level 0, and so on.
+	Delays longer than the top level are parked in its farthest slot and re-filed when it comes around.
+
+	Expired timers are NOT handled in the interrupt.  They're put on a ready queue,
+	and the main loop pulls them off with GetExpiredTimer() and acts on them.
+
+	Sample code:
+
+		void interrupt(void)
+		{
+			byte ms = UiTimeInterrupt();
+			while (ms--)
+				TimerWheelTick();
+		}
+
+		...
+		StartTimer(BLINK_TIMER, 500, 500);
+		StartTimer(BACKLIGHT_TIMER, 10000, 0);
+
+		while (1) {
+			switch (GetExpiredTimer()) {
+			case BLINK_TIMER:
+				...
+			case BACKLIGHT_TIMER:
+				...
+			}
+		}
+
+	Requires timerWheel-consts.h, customized from timerWheel-consts-template.h.
+*/
+
+#ifndef __TIMER_WHEEL_H
+#define __TIMER_WHEEL_H
+
+#ifdef IN_TIMER_WHEEL
+ #define TIMER_WHEEL_EXTERN
+#else
+ #define TIMER_WHEEL_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+#include "timerWheel-consts.h"
+
+
+// Returned by GetExpiredTimer() when nothing has expired.
+#define NO_TIMER  0xFF
+
+
+// The count of ticks (usually ms) processed by the wheel since InitTimerWheel().
+// Rolls over every 65536 ticks; only use differences.
+TIMER_WHEEL_EXTERN unsigned short wheelNow;
+
+
+// Call this once to initialize, before enabling interrupts.
+// All timers start out stopped.
+void InitTimerWheel(void);
+
+// Call this from the interrupt handler once per tick,
+// e.g. once for each ms returned by UiTimeInterrupt().
+// Moves any timers that are due onto the ready queue, and reschedules periodic ones.
+void TimerWheelTick(void);
+
+// Starts (or restarts) the given timer.
+// It will expire after delay ticks (1 - 65535; 0 is treated as 1).
+// If period is nonzero, it will then expire again every period ticks, until stopped.
+// If it was already running, or was expired but not yet collected, that's forgotten.
+void StartTimer(byte id, unsigned short delay, unsigned short period);
+
+// Stops the given timer.
+// Also removes it from the ready queue, if it has expired but not yet been collected.
+// Does nothing if it's not running.
+void StopTimer(byte id);
+
+// Returns true if the given timer is running or has an expiry waiting to be collected.
+byte IsTimerActive(byte id);
+
+// Returns the ID of the next timer that has expired, or NO_TIMER if none have.
+// Call this from the main loop.
+// Timers are returned in the order they expired.
+// A periodic timer that expires again before it's collected is only returned once.
+byte GetExpiredTimer(void);
+
+
+#endif
@@ -0,0 +1,21 @@
+// trace-consts.h
+// Customize this to fit your application.
+
+
+#ifndef __TRACE_CONSTS
+#define __TRACE_CONSTS
+
+// The event IDs, 1-254.  (0 is used for "events were dropped", and 0xFF is reserved.)
+// Replace these with the events needed for your app.
+#define TRACE_SERIAL_RX  1
+#define TRACE_SOUND_TOGGLE  2
+#define TRACE_CAPSENSE_ISR  3
+#define TRACE_ONEWIRE_GIE_OFF  4
+#define TRACE_ONEWIRE_GIE_ON  5
+
+// The number of events the ring holds before new ones are dropped.
+// Must be a power of 2.  Each one costs 6 bytes of RAM.
+#define TRACE_LENGTH  16
+
+
+#endif
@@ -0,0 +1,235 @@
+/* trace.c
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TRACE_HOST_DECODER
+
+#define IN_TRACE
+
+#include <system.h>
+
+#include "trace.h"
+#include "uiTime.h"
+
+
+#ifdef USE_TRACE
+
+#if defined(_PIC18F2620) || defined(_PIC18F2320) || defined(_PIC18F1320) || defined(_PIC18F2550)
+ #define TRACE_TMR0  tmr0l
+#else
+ #define TRACE_TMR0  tmr0
+#endif
+
+#define TRACE_MASK  (TRACE_LENGTH - 1)
+#if TRACE_LENGTH & TRACE_MASK
+ #error "trace.c - TRACE_LENGTH must be a power of 2"
+#endif
+
+// Bytes per event on the wire, including the sync byte.
+#define TRACE_WIRE_LENGTH  7
+
+
+// The ring, one array per field, so each store is a simple index.
+static byte traceId[TRACE_LENGTH];
+static byte traceTicks[TRACE_LENGTH];
+static byte traceMs[TRACE_LENGTH];
+static byte traceSub[TRACE_LENGTH];
+static byte traceData0[TRACE_LENGTH];
+static byte traceData1[TRACE_LENGTH];
+static byte traceHead;
+static byte traceCount;
+
+// The event being sent, and how much of it has gone out.
+static byte traceOut[TRACE_WIRE_LENGTH];
+static byte traceOutPos;
+
+
+void InitTrace(void)
+{
+	traceHead = 0;
+	traceCount = 0;
+	traceDropped = 0;
+	traceOutPos = TRACE_WIRE_LENGTH;
+}
+
+void TraceEvent(byte id, byte data0, byte data1)
+{
+	// Catch the time first, so it's as close to the event as possible.
+	byte sub = TRACE_TMR0;
+
+	// In the ISR, GIE is already off, and stays that way.
+	byte gie = intcon.GIE;
+	intcon.GIE = 0;
+
+	if (traceCount < TRACE_LENGTH) {
+		byte i = (traceHead + traceCount) & TRACE_MASK;
+		traceId[i] = id;
+		traceTicks[i] = ticks;
+		traceMs[i] = tickScaler;
+		traceSub[i] = sub;
+		traceData0[i] = data0;
+		traceData1[i] = data1;
+		++traceCount;
+	} else if (traceDropped != 0xFF)
+		++traceDropped;
+
+	intcon.GIE = gie;
+}
+
+// Fills traceOut with the next event to send, if there is one.
+static void LoadNextEvent(void)
+{
+	traceOut[0] = TRACE_SYNC;
+
+	// Dropped events came after everything in the ring, so they're reported once it's empty.
+	if (!traceCount) {
+		if (!traceDropped)
+			return;
+
+		intcon.GIE = 0;
+		traceOut[1] = TRACE_DROPPED;
+		traceOut[2] = ticks;
+		traceOut[3] = tickScaler;
+		traceOut[4] = 0;
+		traceOut[5] = traceDropped;
+		traceOut[6] = 0;
+		traceDropped = 0;
+		intcon.GIE = 1;
+
+		traceOutPos = 0;
+		return;
+	}
+
+	byte i = traceHead;
+	traceOut[1] = traceId[i];
+	traceOut[2] = traceTicks[i];
+	traceOut[3] = traceMs[i];
+	traceOut[4] = traceSub[i];
+	traceOut[5] = traceData0[i];
+	traceOut[6] = traceData1[i];
+
+	intcon.GIE = 0;
+	traceHead = (i + 1) & TRACE_MASK;
+	--traceCount;
+	intcon.GIE = 1;
+
+	traceOutPos = 0;
+}
+
+void UpdateTrace(void)
+{
+	if (!pir1.TXIF)
+		return;
+
+	if (traceOutPos >= TRACE_WIRE_LENGTH) {
+		LoadNextEvent();
+		if (traceOutPos >= TRACE_WIRE_LENGTH)
+			return;
+	}
+
+	txreg = traceOut[traceOutPos++];
+}
+
+#endif
+
+
+#else
+// TRACE_HOST_DECODER
+
+// A decoder for the host, in plain C.
+// Build with e.g.:
+//	gcc -DTRACE_HOST_DECODER -o tracedecode trace.c
+// and run with a binary capture of the serial port:
+//	tracedecode capture.bin
+// Prints one line per event: the time in ms since the first event, the Timer 0 count
+// for the fraction of a ms, the ID, and the data bytes.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TRACE_SYNC  0xA5
+#define TRACE_DROPPED  0
+#define TRACE_WIRE_LENGTH  7
+#define MS_PER_TICK  250
+#define MS_PER_ROLLOVER  (256L * MS_PER_TICK)
+
+int main(int argc, char** argv)
+{
+	FILE* f = argc > 1? fopen(argv[1], "rb"): stdin;
+	if (!f) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	// Read the whole capture; they're small.
+	unsigned char* buf = NULL;
+	long len = 0;
+	long size = 0;
+	int c;
+	while ((c = getc(f)) != EOF) {
+		if (len == size) {
+			size = size? size * 2: 4096;
+			buf = (unsigned char*) realloc(buf, size);
+			if (!buf) {
+				fprintf(stderr, "out of memory\n");
+				return 1;
+			}
+		}
+		buf[len++] = (unsigned char) c;
+	}
+
+	long skipped = 0;
+	long lastMs = -1;
+	long baseMs = 0;  // for unwrapping the 64-second rollover
+	long firstMs = -1;
+	long p = 0;
+
+	while (p + TRACE_WIRE_LENGTH <= len) {
+		unsigned char* e = buf + p;
+
+		// The sync byte can also turn up as data, so an event only counts if its
+		// ms is possible and the next event (if any) starts with a sync too.
+		if (e[0] != TRACE_SYNC || e[3] >= MS_PER_TICK
+			|| (p + TRACE_WIRE_LENGTH < len && e[TRACE_WIRE_LENGTH] != TRACE_SYNC)) {
+			++skipped;
+			++p;
+			continue;
+		}
+		p += TRACE_WIRE_LENGTH;
+
+		long ms = (long) e[2] * MS_PER_TICK + e[3];
+		if (lastMs >= 0 && ms < lastMs)
+			baseMs += MS_PER_ROLLOVER;
+		lastMs = ms;
+		ms += baseMs;
+		if (firstMs < 0)
+			firstMs = ms;
+
+		if (e[1] == TRACE_DROPPED)
+			printf("%10ld ms            *** %u events dropped\n", ms - firstMs, e[5]);
+		else
+			printf("%10ld ms  +%3u  id %3u  data %02X %02X\n", ms - firstMs, e[4], e[1], e[5], e[6]);
+	}
+
+	skipped += len - p;
+	if (skipped)
+		fprintf(stderr, "%ld bytes skipped while looking for sync\n", skipped);
+
+	free(buf);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,117 @@
+/* trace.h
+    Copyright (c) 2026 by Timothy J. Weber, tw@timothyweber.org.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Binary event tracing, for debugging timing problems.
+
+	Any module - in the ISR or the main loop - can log an event: an ID, up to two
+	bytes of data, and a timestamp from uiTime (ticks, the ms within the tick, and
+	Timer 0 for the fraction of a ms).  Events go into a RAM ring, and UpdateTrace()
+	sends them out the serial port a byte at a time, whenever the transmitter is free.
+	If the ring fills up, new events are dropped and counted, and a "dropped" event
+	goes out in their place.
+
+	Logging an event costs a few dozen cycles: it's just stores into the ring,
+	with interrupts masked for those few instructions when called from the main loop.
+
+	Define USE_TRACE in your project to turn this on.  Without it, the TRACE macros
+	compile to nothing, so they can be left in the code.
+
+	Sample code:
+
+		void interrupt(void)
+		{
+			if (pir1.RCIF)
+				TRACE(TRACE_SERIAL_RX);
+			...
+		}
+
+		...
+		InitializeSerial2(true, true);
+		InitTrace();
+		while (1) {
+			UpdateTrace();
+			...
+		}
+
+	On the wire, each event is 7 bytes:
+		0xA5  (sync)
+		id
+		ticks
+		ms within the tick (0-249)
+		Timer 0
+		data0
+		data1
+	So the time of an event is ticks * 250 + ms, plus Timer 0's fraction of the next ms;
+	that rolls over every 64 seconds.
+	Compile trace.c for the host with TRACE_HOST_DECODER defined to get a decoder,
+	which reads a capture of the serial stream and prints a timeline.
+
+	Requires trace-consts.h, customized from trace-consts-template.h,
+	uiTime, and serial with transmit enabled.
+*/
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#ifdef IN_TRACE
+ #define TRACE_EXTERN
+#else
+ #define TRACE_EXTERN  extern
+#endif
+
+
+#include "types-tjw.h"
+
+#include "trace-consts.h"
+
+
+// The sync byte that starts each event on the wire.
+#define TRACE_SYNC  0xA5
+
+// The ID of the event reporting dropped events; its data0 is how many (up to 255).
+#define TRACE_DROPPED  0
+
+
+#ifdef USE_TRACE
+
+// The number of events dropped since the last "dropped" event was sent.
+TRACE_EXTERN byte traceDropped;
+
+// Call this once, before logging anything.
+void InitTrace(void);
+
+// Logs an event.  Safe to call from the ISR or the main loop.
+void TraceEvent(byte id, byte data0, byte data1);
+
+// Call this from the main loop.  Sends the next byte of the oldest event, if the transmitter is free.
+void UpdateTrace(void);
+
+#define TRACE(id)  TraceEvent(id, 0, 0)
+#define TRACE1(id, data0)  TraceEvent(id, data0, 0)
+#define TRACE2(id, data0, data1)  TraceEvent(id, data0, data1)
+
+#else
+
+#define TRACE(id)
+#define TRACE1(id, data0)
+#define TRACE2(id, data0, data1)
+
+#endif
+
+
+#endif
@@ -40,4 +40,11 @@ inline void setBit(char& reg, byte bitNum, byte testValue)
 // Toggles the specified bit in the specified register.
 #define toggleBit(reg, bitNum)  (reg ^= BITMASK(bitNum))
 
+// Declares a constant table in program memory, initialized from a braced list:
+//	ROM_TABLE(char, monthDays) = { 31, 28, 31, ... };
+// BoostC only takes that as a rom pointer; other compilers (see host/system.h) need an array.
+#ifndef ROM_TABLE
+ #define ROM_TABLE(type, name)  rom type* name
+#endif
+
 #endif
@@ -48,4 +48,6 @@ byte UpdateUiSeconds(void)
 		
 		result = true;
 	}
+	
+	return result;
 }
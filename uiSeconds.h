@@ -17,6 +17,7 @@
 
 // Simple timekeeping; accumulates uiTime's clock ticks into seconds.
 // Range is from one second to 2^16 seconds (~18 hours); accuracy is dependent on uiTime.
+// For longer spans, like uptime stamps in logs, use uiTime's 32-bit uptime instead.
 // Requires uiTime.
 
 #ifndef __UISECONDS_H
@@ -44,7 +45,7 @@ UISECONDS_EXTERN unsigned short seconds;
 // Call this to initialize the module or to reset the counter.
 void ClearUiSeconds(void);
 
-// Call this periodically to update the count.
+// Call this periodically, from the main loop, to update the count.
 // Just needs to be called with as much resolution as is needed for timekeeping.
 // And, must be called at least once a minute.
 // Returns true if we've just rolled over to a new second.
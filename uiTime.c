@@ -36,67 +36,72 @@ void ResetUITimer(void)
 {
 	tickScaler = 0;
 	ticks = 0;
+	uiCycles = 0;
+	#ifdef UITIME_TRIM
+	uiTrimFraction = 0;
+	#endif
+}
+
+unsigned long GetUptime(void)
+{
+	unsigned long result;
+	unsigned long check;
+	
+	do {
+		result = uptime;
+		check = uptime;
+	} while (result != check);
+	
+	return result;
 }
 
 void InitUiTime_Timer0(void)
 {
 	#if defined(_PIC12F675) || defined(_PIC16F916) || defined(_PIC16F688) || defined(_PIC12F683) || defined(_PIC16F883) || defined(_PIC16F886)
 	option_reg.T0CS = 0;  // T0 transition on internal CLKOUT
-	option_reg = (option_reg & 0xF0) | 0x01;  // 1:4 prescaler on Timer 0: rolls over with a period of 1.024 ms.
+	option_reg = (option_reg & 0xF0) | UITIME_T0_PS_BITS;  // prescaler chosen in uiTime.h
 	intcon.T0IE = 1;
 	#elif defined(_PIC18F2620) || defined(_PIC18F2320) || defined(_PIC18F1320) || defined(_PIC18F2550)
 	// Enable the timer 0 interrupt, and set prescaler.
-	t0con = 0xC1;  // 1:4 prescaler on an 8-bit Timer 0: rolls over with a period of 1.024 ms.
+	t0con = 0xC0 | UITIME_T0_PS_BITS;  // 8-bit Timer 0 on the instruction clock, prescaler chosen in uiTime.h
 	intcon.TMR0IE = 1;
 	#else
 		#error "uiTime.c - update for this chip"
 	#endif
 
 	intcon.PEIE = 1;
-	tickScaler = 0;
-	ticks = 0;
+	ResetUITimer();
+	ResetUptime();
 }
 
-void InitUiTime_Timer0_8MHz(void)
-{
-	// Enable the timer 0 interrupt, and set prescaler.
-	#if defined(_PIC18F2620) || defined(_PIC18F2320) || defined(_PIC18F1320) || defined(_PIC18F2550)
-	t0con = 0xC2;  // 1:8 prescaler on an 8-bit Timer 0: rolls over with a period of 1.024 ms.
-	intcon.TMR0IE = 1;
-	#elif defined(_PIC16F688)
-	option_reg = (option_reg & 0b11000000) | 0b000000  // Timer 0 counts instructions
-		| 0b0000  // Timer 0 ges the 8-bit prescaler, not the watchdog
-		| 0b010;  // Prescaler 1:8
-	#else
-		#error "uiTime.c - update for this chip"
-	#endif
+// Instruction cycles counted toward the next tick, when using Timer 1.
+// Needs to be long, since the timer's period is longer than a tick at most clock rates.
+static unsigned long uiCycles1;
 
-	intcon.PEIE = 1;
-	tickScaler = 0;
-	ticks = 0;
-}
+#define UITIME_CYCLES_PER_TICK  ((unsigned long) UITIME_CYCLES_PER_MS * MS_PER_TICK)
 
 void InitUiTime_Timer1(void)
 {
 	pie1.TMR1IE = 1;
 	intcon.PEIE = 1;
-	t1con = 0x01;  // prescale 1:1 on 16-bit counter @ 1 MHz.
-		// 1:4 would get you ~4 Hz, but we count those manually for more resolution.
-	tickScaler = 0;
-	ticks = 0;
+	t1con = 0x01;  // prescale 1:1 on 16-bit counter, on the instruction clock.
+		// We carry the fractional ticks manually, so it needn't divide evenly.
+	ResetUITimer();
+	ResetUptime();
+	uiCycles1 = 0;
 }
 
 void UiTimeInterrupt1(void)
 {
-	// Timer 1, rolling over with a 65.536 ms period.
+	// Timer 1, rolling over every 65536 cycles (65.536 ms at 4 MHz).
 	if (pir1.TMR1IF) {
 		// Clear the interrupt.
 		pir1.TMR1IF = 0;
 
-		++tickScaler;
-		if (tickScaler >= 4) {
-			ticks++;
-			tickScaler = 0;
+		uiCycles1 += 65536;
+		while (uiCycles1 >= UITIME_CYCLES_PER_TICK) {
+			uiCycles1 -= UITIME_CYCLES_PER_TICK;
+			UiTimeAddTick();
 		}
 	} 
 }
@@ -104,13 +109,14 @@ void UiTimeInterrupt1(void)
 void InitUiTime_60Hz(void)
 {
 	ResetUITimer();
+	ResetUptime();
 }
 
 void UiTimeUpdate60(void)
 {
 	if (++tickScaler >= 15) {
 		tickScaler = 0;
-		ticks++;
+		UiTimeAddTick();
 	}
 }
 
@@ -119,31 +125,24 @@ void InitUiTime_Freq(unsigned char  NBy4)
 {
 	tickScaleVal = NBy4;
 	ResetUITimer();
+	ResetUptime();
 }
 
 void UiTimeUpdateFreq(void)
 {
 	if (++tickScaler >= tickScaleVal) {
 		tickScaler = 0;
-		ticks++;
+		UiTimeAddTick();
 	}
 }
 
 void InitUiTime256(void)
 {
 	ResetUITimer();
+	ResetUptime();
 }
 
 unsigned char UiTimeUpdate256(void)
 {
-	static unsigned char postScaler4 = 0;
-	
-	if (++postScaler4 >= 4) {
-		postScaler4 = 0;
-
-		if (++tickScaler == 0)
-			ticks++;
-		return true;
-	} else
-		return false;
+	return UiTimeAddCycles(256);
 }
@@ -21,6 +21,15 @@
 //
 // Can be driven off of Timer 0 or Timer 1 with most of the overhead handled here,
 // or from a 60 Hz external signal.
+//
+// When driven from a timer, the timer's period generally isn't a whole number of ms.
+// So, elapsed instruction cycles are accumulated, and whole ms are carried out of them
+// with the remainder kept (Bresenham-style).
+// The ms count always lags real time a little - by at most one ms plus one timer period -
+// but that error doesn't build up: over the long run, ms, ticks, and seconds are as exact
+// as the oscillator.  (At 4 MHz with Timer 0, the worst-case lag is 2016 cycles, about 2 ms,
+// no matter how long it runs, and it stays under 3 ms at rates up to 48 MHz;
+// see host/uiTimeDrift.cpp.)
 
 #ifndef __UITIME_H
 #define __UITIME_H
@@ -32,9 +41,22 @@
 #endif
 
 
+// The oscillator frequency, in Hz.
+// Define this in your project's settings if it's not 4 MHz.
+// Must be a multiple of 4 kHz, so a ms is a whole number of instruction cycles.
+#ifndef UITIME_FOSC
+ #define UITIME_FOSC  4000000
+#endif
+
+#define UITIME_CYCLES_PER_MS  (UITIME_FOSC / 4000)
+#if UITIME_CYCLES_PER_MS * 4000 != UITIME_FOSC
+ #error "uiTime.h - UITIME_FOSC must be a multiple of 4 kHz"
+#endif
+
+
 // Count of ticks since startup.
-// A "tick" happens roughly four times per second.
-// Rolls over about every 64 - 67 seconds.
+// A "tick" happens four times per second.
+// Rolls over every 64 seconds.
 // Seems to be a convenient time unit for many UI-related short delays.
 //
 // Always use the difference between the current value of ticks and some previously-stored value;
@@ -42,57 +64,184 @@
 //
 // Only change this value if it's only used to mean one thing in your app.
 // If you only need one UI timer, you can save one byte of RAM that way (FWTW).
-//
-// ASSUMES A CLOCK RATE OF 4 MHz at the moment!
 UITIME_EXTERN unsigned char ticks;
 
+// Count of whole seconds since startup, advanced along with ticks.
+// Rolls over after 136 years, so it's good for uptime stamps.
+// Read it from outside the ISR with GetUptime().
+// Volatile, so GetUptime()'s two reads really are two reads.
+// Cleared by the InitUiTime_* routines.
+UITIME_EXTERN volatile unsigned long uptime;
+
+// Ticks toward the next second of uptime.
+// Counted apart from ticks, so resetting or writing ticks doesn't lose any uptime.
+UITIME_EXTERN unsigned char uptimeTicks;
+
 // Resets the timer to 0.
+// Doesn't touch uptime, so the UI timer can be reset without losing it.
 void ResetUITimer(void);
 
+// Clears uptime.  The InitUiTime_* routines call this.
+inline void ResetUptime(void)
+{
+	uptime = 0;
+	uptimeTicks = 0;
+}
+
 // Express your desired timeouts and delay factors in terms of this.
 #define TICKS_PER_SEC  4
 #define LOG2_TICKS_PER_SEC  2
+#define MS_PER_TICK  250
+
+// Advances ticks, and uptime on every fourth one.
+// (For internal use by the drivers below.)
+inline void UiTimeAddTick(void)
+{
+	++ticks;
+	if (++uptimeTicks >= TICKS_PER_SEC) {
+		uptimeTicks = 0;
+		++uptime;
+	}
+}
+
+// Returns uptime, read consistently without masking interrupts.
+// It's read until two reads agree; since it only changes once a second,
+// that's almost always on the first try.
+unsigned long GetUptime(void);
 
 
 //====================================================================
 // Routines for using Timer 0 or 1 as the time source
 
-// Rolls over every "tick".
-// A tick is 0.262 seconds; there are about 3.8 per second.
-// Driven by Timer 0.
+// Timer 0 is run free, with the smallest prescaler that makes its period at least 1 ms.
+// It's never reloaded, since writing TMR0 clears the prescaler and loses counts.
+#if UITIME_CYCLES_PER_MS <= 256
+ #define UITIME_T0_PRESCALE  1
+ #define UITIME_T0_PS_BITS  0x08  // PSA: prescaler assigned elsewhere
+#elif UITIME_CYCLES_PER_MS <= 512
+ #define UITIME_T0_PRESCALE  2
+ #define UITIME_T0_PS_BITS  0x00
+#elif UITIME_CYCLES_PER_MS <= 1024
+ #define UITIME_T0_PRESCALE  4
+ #define UITIME_T0_PS_BITS  0x01
+#elif UITIME_CYCLES_PER_MS <= 2048
+ #define UITIME_T0_PRESCALE  8
+ #define UITIME_T0_PS_BITS  0x02
+#elif UITIME_CYCLES_PER_MS <= 4096
+ #define UITIME_T0_PRESCALE  16
+ #define UITIME_T0_PS_BITS  0x03
+#elif UITIME_CYCLES_PER_MS <= 8192
+ #define UITIME_T0_PRESCALE  32
+ #define UITIME_T0_PS_BITS  0x04
+#elif UITIME_CYCLES_PER_MS <= 16384
+ #define UITIME_T0_PRESCALE  64
+ #define UITIME_T0_PS_BITS  0x05
+#else
+ #error "uiTime.h - UITIME_FOSC is too fast for Timer 0 at 1 ms"
+#endif
+
+// Instruction cycles per Timer 0 interrupt.
+#define UITIME_CYCLES_PER_INT  (256 * UITIME_T0_PRESCALE)
+
+// Counts ms within the current tick, 0 to MS_PER_TICK - 1, when driven by Timer 0
+// or a 256-cycle timer.  (The external-source drivers use it to count their updates.)
 UITIME_EXTERN unsigned char tickScaler;
 
+// Instruction cycles counted toward the next ms.
+// Internal; always less than UITIME_CYCLES_PER_MS between interrupts.
+UITIME_EXTERN unsigned short uiCycles;
+
+#ifdef UITIME_TRIM
+// Define UITIME_TRIM in your project to allow fine-tuning Timer 0's rate,
+// e.g. to correct an inaccurate oscillator; see timeDiscipline.h.
+
+// The adjustment, in 1/256ths of an instruction cycle per Timer 0 interrupt.
+// Positive values make time run faster.
+// (At 4 MHz, each unit is about 3.8 ppm.)
+// Keep it within +/-0x7F00, so adding the carried fraction can't overflow.
+UITIME_EXTERN signed short uiTrim;
+
+// The fractional cycles carried between interrupts.  Internal.
+UITIME_EXTERN signed short uiTrimFraction;
+
+// Returns the whole cycles of trim due at this interrupt, keeping the fraction.
+inline signed short UiTimeTrimCycles(void)
+{
+	uiTrimFraction += uiTrim;
+	signed short result = uiTrimFraction >> 8;
+	uiTrimFraction &= 0xFF;
+	return result;
+}
+#endif
+
 // Initializes, and dedicates Timer 0 for use and maintenance by this module.
 // Requires that GIE is enabled elsewhere, and that UiTimeInterrupt is called.
 void InitUiTime_Timer0(void);
 
-// Same, but use if the clock speed is 8 MHz.
-void InitUiTime_Timer0_8MHz(void);
+// Obsolete: define UITIME_FOSC as 8000000 and call InitUiTime_Timer0() instead.
+// Only defined when UITIME_FOSC is 8 MHz, so old callers that haven't set it fail to build,
+// rather than running at the 4 MHz default's rate.
+#if UITIME_FOSC == 8000000
+inline void InitUiTime_Timer0_8MHz(void)
+{
+	InitUiTime_Timer0();
+}
+#endif
 
 // Initializes, and dedicates Timer 1 for use and maintenance by this module.
 // Requires that GIE is enabled elsewhere, and that UiTimeInterrupt1 is called.
 void InitUiTime_Timer1(void);
 
+// Adds the given number of instruction cycles to the count,
+// and advances tickScaler and ticks by however many whole ms that makes.
+// Returns the number of whole ms.
+// (For internal use by the timer drivers below.)
+inline unsigned char UiTimeAddCycles(unsigned short cycles)
+{
+	unsigned char result = 0;
+
+	uiCycles += cycles;
+	while (uiCycles >= UITIME_CYCLES_PER_MS) {
+		uiCycles -= UITIME_CYCLES_PER_MS;
+		++result;
+
+		if (++tickScaler >= MS_PER_TICK) {
+			tickScaler = 0;
+			UiTimeAddTick();
+		}
+	}
+
+	return result;
+}
+
 // Call this in your interrupt handler if using Timer 0.
-// Returns true about once a millisecond, which can be used for other tasks.
-// E.g.:
+// Returns the number of ms that have just elapsed, or 0 if there was no Timer 0 interrupt.
+// That's usually 1, and sometimes 2 (when the carried-over fractions add up to another ms).
+// So it can be used as a flag for about-once-a-millisecond tasks, e.g.:
 //
 //	void interrupt(void)
 //	{
 //		if (UiTimeInterrupt())
 //			CheckButtons();
 //	}
+//
+// or counted down when exact ms matter, e.g.:
+//
+//	byte ms = UiTimeInterrupt();
+//	while (ms--)
+//		UpdateSoundMs();
 inline unsigned char UiTimeInterrupt(void)
 {
-	// Timer 0, rolling over with a 1.024 ms period.
+	// Timer 0, rolling over every UITIME_CYCLES_PER_INT cycles.
 	if (intcon.T0IF) {
 		// Clear the interrupt.
 		intcon.T0IF = 0;
 
-		if (++tickScaler == 0)
-			ticks++;
-
-		return true;
+		#ifdef UITIME_TRIM
+		return UiTimeAddCycles(UITIME_CYCLES_PER_INT + UiTimeTrimCycles());
+		#else
+		return UiTimeAddCycles(UITIME_CYCLES_PER_INT);
+		#endif
 	} else
 		return false;
 }
@@ -132,7 +281,8 @@ void UiTimeUpdateFreq(void);
 void InitUiTime256(void);
 
 // Call this every 256 cycles to update.
-// Returns true about once a millisecond, which can be used for other tasks.
+// Returns the number of whole ms that have just elapsed (0 or 1, or 2 below 1 MHz),
+// which can be used for other tasks.
 unsigned char UiTimeUpdate256(void);
 
 